@@ -1,6 +1,19 @@
 #include <UnitTest++/UnitTest++.h>
+#include "VectorParser.h"
+#include "ResultWriter.h"
+#include "Checkpoint.h"
+#include "ResultCache.h"
+#include "VectorDedup.h"
+#include "BinaryFormat.h"
 #include <stdexcept>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <sys/stat.h>
 
 // Заглушки для классов
 class DataReader {
@@ -119,6 +132,572 @@ TEST(UserInterface_Constructor_InvalidOption) {
     }
 }
 
+// Тесты для VectorParser (реальный модуль из client/)
+
+// Ядра, доступные на этой машине: скалярное есть всегда
+std::vector<VectorParser::Kernel> availableKernels() {
+    std::vector<VectorParser::Kernel> kernels = {VectorParser::Kernel::Scalar};
+    VectorParser::Kernel best = VectorParser::detectKernel();
+    if (best == VectorParser::Kernel::SSE42 || best == VectorParser::Kernel::AVX2) {
+        kernels.push_back(VectorParser::Kernel::SSE42);
+    }
+    if (best == VectorParser::Kernel::AVX2) {
+        kernels.push_back(VectorParser::Kernel::AVX2);
+    }
+    return kernels;
+}
+
+template <class T>
+std::vector<T> parseWith(VectorParser::Kernel kernel, const std::string& line) {
+    std::vector<T> values;
+    VectorParser(kernel).parseLine(line, 1, values);
+    return values;
+}
+
+// Ошибка разбора line ядром kernel; без ошибки — строка 0
+template <class T>
+ParseError parseErrorWith(VectorParser::Kernel kernel, const std::string& line, size_t lineNumber = 1) {
+    std::vector<T> values;
+    try {
+        VectorParser(kernel).parseLine(line, lineNumber, values);
+    } catch (const ParseError& e) {
+        return e;
+    }
+    return ParseError("no error", 0, 0);
+}
+
+TEST(VectorParser_KernelsAgreeOnLongLine) {
+    // Больше 64 байт, чтобы числа пересекали границы блоков классификации
+    std::string line = " 1\t-2  +3 999999999999999999\r -999999999999999999 9223372036854775807 ";
+    line += "-9223372036854775808 0000000000000000000042 12345678 -87654321 7\n";
+    std::vector<int64_t> expected = {1, -2, 3, 999999999999999999LL, -999999999999999999LL, INT64_MAX,
+                                     INT64_MIN, 42, 12345678, -87654321, 7};
+    for (VectorParser::Kernel kernel : availableKernels()) {
+        std::vector<int64_t> values = parseWith<int64_t>(kernel, line);
+        CHECK_EQUAL(expected.size(), values.size());
+        CHECK(values == expected);
+    }
+}
+
+TEST(VectorParser_KernelsAgreeOnEveryOffset) {
+    // Одно и то же число на всех смещениях внутри 64-байтного блока
+    for (VectorParser::Kernel kernel : availableKernels()) {
+        for (size_t pad = 0; pad < 80; ++pad) {
+            std::string line = std::string(pad, ' ') + "-123456789012345678 " + std::string(pad % 3, '\t') + "+9";
+            std::vector<int64_t> values = parseWith<int64_t>(kernel, line);
+            CHECK_EQUAL(2u, values.size());
+            CHECK_EQUAL(-123456789012345678LL, values[0]);
+            CHECK_EQUAL(9, values[1]);
+        }
+    }
+}
+
+TEST(VectorParser_DigitBoundaries) {
+    for (VectorParser::Kernel kernel : availableKernels()) {
+        // 18 цифр — быстрый путь, 19 — через from_chars с проверкой
+        CHECK_EQUAL(999999999999999999LL, parseWith<int64_t>(kernel, "999999999999999999")[0]);
+        CHECK_EQUAL(1000000000000000000LL, parseWith<int64_t>(kernel, "1000000000000000000")[0]);
+        CHECK_EQUAL(INT64_MAX, parseWith<int64_t>(kernel, "9223372036854775807")[0]);
+        CHECK_EQUAL(INT64_MAX, parseWith<int64_t>(kernel, "+9223372036854775807")[0]);
+        CHECK_EQUAL(INT64_MIN, parseWith<int64_t>(kernel, "-9223372036854775808")[0]);
+        CHECK_EQUAL(0, parseWith<int64_t>(kernel, "-0")[0]);
+
+        CHECK_EQUAL(std::string("int64 overflow '9223372036854775808'"),
+                    parseErrorWith<int64_t>(kernel, "9223372036854775808").detail());
+        CHECK_EQUAL(std::string("int64 overflow '-9223372036854775809'"),
+                    parseErrorWith<int64_t>(kernel, "-9223372036854775809").detail());
+        CHECK_EQUAL(std::string("int64 overflow '99999999999999999999'"),
+                    parseErrorWith<int64_t>(kernel, "99999999999999999999").detail());
+
+        CHECK_EQUAL(INT32_MAX, parseWith<int32_t>(kernel, "2147483647")[0]);
+        CHECK_EQUAL(INT32_MIN, parseWith<int32_t>(kernel, "-2147483648")[0]);
+        CHECK_EQUAL(999999999, parseWith<int32_t>(kernel, "999999999")[0]);
+        CHECK_EQUAL(1u, parseErrorWith<int32_t>(kernel, "2147483648").line());
+
+        CHECK_EQUAL(UINT64_MAX, parseWith<uint64_t>(kernel, "18446744073709551615")[0]);
+        CHECK_EQUAL(9999999999999999999ULL, parseWith<uint64_t>(kernel, "9999999999999999999")[0]);
+        CHECK_EQUAL(1u, parseErrorWith<uint64_t>(kernel, "18446744073709551616").line());
+        CHECK_EQUAL(1u, parseErrorWith<uint64_t>(kernel, "-1").line());
+
+        CHECK_EQUAL(-0.25, parseWith<double>(kernel, "-0.25")[0]);
+        CHECK_EQUAL(123456789012345.0, parseWith<double>(kernel, "+123456789012345")[0]);
+    }
+}
+
+TEST(VectorParser_Signs) {
+    for (VectorParser::Kernel kernel : availableKernels()) {
+        std::vector<int64_t> values = parseWith<int64_t>(kernel, "+1 -1 +0 -12345678 +12345678");
+        std::vector<int64_t> expected = {1, -1, 0, -12345678, 12345678};
+        CHECK(values == expected);
+
+        // Знак без цифр, двойной знак и знак внутри числа — ошибки
+        for (const char* bad : {"+", "-", "+-5", "-+5", "--5", "5-", "1+2"}) {
+            ParseError e = parseErrorWith<int64_t>(kernel, bad);
+            CHECK_EQUAL(1u, e.line());
+            CHECK_EQUAL(1u, e.column());
+        }
+    }
+}
+
+TEST(VectorParser_ErrorPosition) {
+    for (VectorParser::Kernel kernel : availableKernels()) {
+        ParseError e = parseErrorWith<int64_t>(kernel, "1 2  x3 4", 7);
+        CHECK_EQUAL(7u, e.line());
+        CHECK_EQUAL(6u, e.column());
+        CHECK_EQUAL(std::string("invalid number 'x3'"), e.detail());
+        CHECK_EQUAL(std::string("Parse error at line 7, column 6: invalid number 'x3'"), std::string(e.what()));
+
+        // Позиция за пределами первого 64-байтного блока
+        std::string line = std::string(70, ' ') + "12 1.5";
+        e = parseErrorWith<int64_t>(kernel, line, 3);
+        CHECK_EQUAL(3u, e.line());
+        CHECK_EQUAL(74u, e.column());
+        CHECK_EQUAL(std::string("invalid number '1.5'"), e.detail());
+    }
+}
+
+TEST(VectorParser_EmptyAndBlankLines) {
+    for (VectorParser::Kernel kernel : availableKernels()) {
+        CHECK(parseWith<int64_t>(kernel, "").empty());
+        CHECK(parseWith<int64_t>(kernel, " \t\r\n\v\f").empty());
+        CHECK(parseWith<int64_t>(kernel, std::string(200, ' ')).empty());
+    }
+}
+
+TEST(VectorParser_ParseVectorAppendsToBatch) {
+    VectorParser parser;
+    VectorBatch batch(ElementType::Int32);
+    parser.parseVector("1 2 3", 1, batch);
+    parser.parseVector("", 2, batch);
+    parser.parseVector("-4", 3, batch);
+    CHECK_EQUAL(3u, batch.size());
+    CHECK_EQUAL(3u, batch[0].size);
+    CHECK_EQUAL(0u, batch[1].size);
+    CHECK_EQUAL(-4, batch[2].values<int32_t>()[0]);
+    CHECK_EQUAL(sizeof(int32_t), batch[2].width);
+}
+
+// Тесты для ResultWriter (реальный модуль из client/)
+
+// Ожидаемое содержимое выходного файла: количество и ячейки int32
+std::string encodedResults(const std::vector<int32_t>& values) {
+    uint32_t count = values.size();
+    std::string bytes(reinterpret_cast<const char*>(&count), sizeof(count));
+    bytes.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int32_t));
+    return bytes;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(ResultWriter_RegularFileIsMapped) {
+    std::string path = "result_writer_test.bin";
+    ResultWriter writer(path, ElementType::Int32);
+    writer.open(3);
+    writer.set(2, -7);
+    writer.set(0, 5);
+    // До finish количество в заголовке — 0
+    CHECK(readFile(path).substr(0, 4) == std::string(4, '\0'));
+    writer.finish();
+    CHECK(readFile(path) == encodedResults({5, 0, -7}));
+    std::remove(path.c_str());
+}
+
+TEST(ResultWriter_PipeGetsHeaderFirst) {
+    int fds[2];
+    CHECK_EQUAL(0, pipe(fds));
+    {
+        // Канал нельзя отобразить в память: результаты пишутся при finish
+        ResultWriter writer("/dev/fd/" + std::to_string(fds[1]), ElementType::Int32);
+        writer.open(3);
+        CHECK(writer.isOpen());
+        writer.set(1, 42);
+        writer.set(2, 3);
+        writer.set(0, -1);
+        writer.finish();
+    }
+    close(fds[1]);
+    std::string received;
+    char chunk[64];
+    ssize_t got;
+    while ((got = read(fds[0], chunk, sizeof(chunk))) > 0) {
+        received.append(chunk, got);
+    }
+    close(fds[0]);
+    CHECK(received == encodedResults({-1, 42, 3}));
+}
+
+// Тесты для Checkpoint (реальный модуль из client/)
+
+void writeTextFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+// Сообщение исключения из load; без исключения — пустая строка
+std::string checkpointLoadError(const std::string& path, const std::string& input, ElementType type) {
+    std::vector<int64_t> results;
+    try {
+        Checkpoint::load(path, input, type, results);
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+TEST(Checkpoint_SaveAndLoad) {
+    std::string input = "checkpoint_test_input.txt";
+    std::string path = Checkpoint::pathFor("checkpoint_test.bin");
+    CHECK_EQUAL(std::string("checkpoint_test.bin.ckpt"), path);
+    writeTextFile(input, "1 2\n3 4\n5 6\n7 8\n");
+
+    std::vector<int64_t> results = {3, 7, 11, 15};
+    {
+        Checkpoint checkpoint(path, input, ElementType::Int64, {});
+        checkpoint.update(results.data(), 2);
+        checkpoint.update(results.data(), 3);
+        // Меньший префикс ничего не меняет
+        checkpoint.update(results.data(), 1);
+        CHECK_EQUAL(3u, checkpoint.saved());
+    }
+
+    std::vector<int64_t> loaded;
+    CHECK(Checkpoint::load(path, input, ElementType::Int64, loaded));
+    CHECK(loaded == std::vector<int64_t>({3, 7, 11}));
+
+    // Продолженный запуск начинает с загруженного префикса и дописывает остальное
+    {
+        Checkpoint checkpoint(path, input, ElementType::Int64, loaded);
+        CHECK_EQUAL(3u, checkpoint.saved());
+        checkpoint.update(results.data(), 4);
+    }
+    CHECK(Checkpoint::load(path, input, ElementType::Int64, loaded));
+    CHECK(loaded == results);
+
+    Checkpoint(path, input, ElementType::Int64, {}).remove();
+    CHECK(!Checkpoint::load(path, input, ElementType::Int64, loaded));
+    std::remove(input.c_str());
+}
+
+TEST(Checkpoint_RejectsChangedInputAndType) {
+    std::string input = "checkpoint_test_input.txt";
+    std::string path = "checkpoint_test.bin.ckpt";
+    writeTextFile(input, "1 2\n3 4\n");
+    std::vector<int64_t> results = {3, 7};
+    Checkpoint written(path, input, ElementType::Int64, results);
+
+    CHECK_EQUAL(std::string("Checkpoint checkpoint_test.bin.ckpt was written for element type int64, not double"),
+                checkpointLoadError(path, input, ElementType::Double));
+    CHECK_EQUAL(std::string(""), checkpointLoadError(path, input, ElementType::Int64));
+
+    writeTextFile(input, "1 2\n3 4\n5 6\n");
+    CHECK_EQUAL(std::string("Input file changed since checkpoint checkpoint_test.bin.ckpt was written"),
+                checkpointLoadError(path, input, ElementType::Int64));
+
+    std::remove(path.c_str());
+    std::remove(input.c_str());
+}
+
+TEST(Checkpoint_RejectsTruncatedFile) {
+    std::string input = "checkpoint_test_input.txt";
+    std::string path = "checkpoint_test.bin.ckpt";
+    writeTextFile(input, "1 2\n3 4\n5 6\n");
+    std::vector<int64_t> results = {3, 7, 11};
+    Checkpoint written(path, input, ElementType::Int64, results);
+
+    // done говорит о трёх результатах, а в файле их два
+    struct stat info;
+    CHECK_EQUAL(0, stat(path.c_str(), &info));
+    CHECK_EQUAL(0, truncate(path.c_str(), info.st_size - sizeof(int64_t)));
+    CHECK_EQUAL(std::string("Corrupted checkpoint: checkpoint_test.bin.ckpt"),
+                checkpointLoadError(path, input, ElementType::Int64));
+
+    // Огромный done отвергается до выделения памяти под результаты
+    Checkpoint rewritten(path, input, ElementType::Int64, results);
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t done = 0xffffffff;
+        file.seekp(4);
+        file.write(reinterpret_cast<const char*>(&done), sizeof(done));
+    }
+    CHECK_EQUAL(std::string("Corrupted checkpoint: checkpoint_test.bin.ckpt"),
+                checkpointLoadError(path, input, ElementType::Int64));
+
+    writeTextFile(path, "not a checkpoint at all, just some text");
+    CHECK_EQUAL(std::string("Corrupted checkpoint: checkpoint_test.bin.ckpt"),
+                checkpointLoadError(path, input, ElementType::Int64));
+
+    std::remove(path.c_str());
+    std::remove(input.c_str());
+}
+
+// Тесты для ResultCache (реальный модуль из client/)
+
+// Ключ, половины которого попадают в группы lowGroup и highGroup
+// таблицы наименьшего размера (8 групп: номер — старшие 3 бита)
+VectorKey cacheKey(uint64_t lowGroup, uint64_t highGroup, uint64_t id) {
+    return {(lowGroup << 61) | id, (highGroup << 61) | id};
+}
+
+TEST(ResultCache_InsertLookupPersists) {
+    std::string path = "result_cache_test.bin";
+    std::remove(path.c_str());
+    {
+        ResultCache cache(path, 0);
+        CHECK_EQUAL(64u, cache.capacity());
+        CHECK_EQUAL(64u + 64u * 32u, cache.fileBytes());
+        cache.insert(cacheKey(1, 5, 1), -42);
+        cache.insert(cacheKey(2, 6, 2), 7);
+        // Повторная вставка обновляет запись
+        cache.insert(cacheKey(2, 6, 2), 8);
+        CHECK_EQUAL(2u, cache.entries());
+    }
+    ResultCache cache(path, 0);
+    int64_t result = 0;
+    CHECK(cache.lookup(cacheKey(1, 5, 1), result));
+    CHECK_EQUAL(-42, result);
+    CHECK(cache.lookup(cacheKey(2, 6, 2), result));
+    CHECK_EQUAL(8, result);
+    CHECK(!cache.lookup(cacheKey(1, 5, 3), result));
+    CHECK_EQUAL(3u, cache.stats().lookups);
+    CHECK_EQUAL(2u, cache.stats().hits);
+    CHECK_EQUAL(2u, cache.entries());
+    std::remove(path.c_str());
+}
+
+TEST(ResultCache_NotACacheFile) {
+    std::string path = "result_cache_test.bin";
+    writeTextFile(path, std::string(200, 'x'));
+    CHECK_THROW(ResultCache(path, 0), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(ResultCache_UsesBothGroups) {
+    std::string path = "result_cache_test.bin";
+    std::remove(path.c_str());
+    ResultCache cache(path, 0);
+    // Ключи с обеими половинами в группе 0 умещаются только в её 8 ячеек
+    for (uint64_t id = 0; id < 9; ++id) {
+        cache.insert(cacheKey(0, 0, id), id);
+    }
+    CHECK_EQUAL(8u, cache.entries());
+    CHECK_EQUAL(1u, cache.stats().evictions);
+
+    // Ключи групп 3 и 4 заполняют обе группы, прежде чем вытеснять
+    for (uint64_t id = 0; id < 16; ++id) {
+        cache.insert(cacheKey(3, 4, id), 100 + id);
+    }
+    CHECK_EQUAL(24u, cache.entries());
+    CHECK_EQUAL(1u, cache.stats().evictions);
+    int64_t result = 0;
+    for (uint64_t id = 0; id < 16; ++id) {
+        CHECK(cache.lookup(cacheKey(3, 4, id), result));
+        CHECK_EQUAL(static_cast<int64_t>(100 + id), result);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(ResultCache_EvictsLeastRecentlyUsed) {
+    std::string path = "result_cache_test.bin";
+    std::remove(path.c_str());
+    {
+        ResultCache cache(path, 0);
+        for (uint64_t id = 0; id < 16; ++id) {
+            cache.insert(cacheKey(5, 6, id), id);
+        }
+    }
+    {
+        // В следующем запуске используются все записи, кроме 9-й
+        ResultCache cache(path, 0);
+        int64_t result = 0;
+        for (uint64_t id = 0; id < 16; ++id) {
+            if (id != 9) {
+                CHECK(cache.lookup(cacheKey(5, 6, id), result));
+            }
+        }
+        cache.insert(cacheKey(5, 6, 16), 16);
+        CHECK_EQUAL(1u, cache.stats().evictions);
+        CHECK_EQUAL(16u, cache.entries());
+    }
+    ResultCache cache(path, 0);
+    int64_t result = 0;
+    CHECK(!cache.lookup(cacheKey(5, 6, 9), result));
+    for (uint64_t id = 0; id <= 16; ++id) {
+        if (id != 9) {
+            CHECK(cache.lookup(cacheKey(5, 6, id), result));
+            CHECK_EQUAL(static_cast<int64_t>(id), result);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+// Тесты для VectorDedup (реальный модуль из client/)
+
+TEST(VectorDedup_CollectGroupsByPosition) {
+    // Векторы A B A C B A: отправляются A, B и C, повторы получают их результат
+    VectorKey a = {1, 10}, b = {2, 20}, c = {3, 30};
+    std::vector<VectorKey> keys = {a, b, a, c, b, a};
+    VectorDedup dedup(keys.size(), 1 << 20);
+    size_t positions = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!dedup.duplicate(keys[i], i)) {
+            dedup.add(keys[i], positions++);
+        }
+    }
+    CHECK_EQUAL(3u, positions);
+    CHECK_EQUAL(3u, dedup.duplicates());
+    CHECK(!dedup.limited());
+
+    std::vector<uint32_t> offsets, indices;
+    dedup.collect(positions, offsets, indices);
+    CHECK(offsets == std::vector<uint32_t>({0, 2, 3, 3}));
+    CHECK(indices == std::vector<uint32_t>({2, 5, 4}));
+}
+
+TEST(VectorDedup_KeysWithSameLowHalfDiffer) {
+    // Одна ячейка таблицы: различаются только старшие половины
+    VectorDedup dedup(4, 1 << 20);
+    dedup.add({7, 1}, 0);
+    dedup.add({7, 2}, 1);
+    CHECK(dedup.duplicate({7, 2}, 5));
+    CHECK(!dedup.duplicate({7, 3}, 6));
+    std::vector<uint32_t> offsets, indices;
+    dedup.collect(2, offsets, indices);
+    CHECK(offsets == std::vector<uint32_t>({0, 0, 1}));
+    CHECK(indices == std::vector<uint32_t>({5}));
+}
+
+TEST(VectorDedup_MemoryLimit) {
+    // Без памяти на повторы: таблица наименьшего размера (16 ячеек, 12 ключей)
+    VectorDedup none(100, 0);
+    none.add({1, 1}, 0);
+    CHECK(!none.duplicate({1, 1}, 1));
+    CHECK(none.limited());
+
+    // Таблица из 16 ячеек по 24 байта и место ровно на два повтора
+    VectorDedup dedup(100, 16 * 24 + 2 * 8);
+    for (uint64_t k = 0; k < 13; ++k) {
+        dedup.add({k, k}, k);
+    }
+    // 13-й ключ не поместился и не запоминается
+    CHECK(dedup.limited());
+    CHECK(!dedup.duplicate({12, 12}, 20));
+    CHECK(dedup.duplicate({0, 0}, 21));
+    CHECK(dedup.duplicate({1, 1}, 22));
+    CHECK(!dedup.duplicate({2, 2}, 23));
+    CHECK_EQUAL(2u, dedup.duplicates());
+
+    std::vector<uint32_t> offsets, indices;
+    dedup.collect(12, offsets, indices);
+    CHECK_EQUAL(13u, offsets.size());
+    CHECK_EQUAL(1u, offsets[1]);
+    CHECK_EQUAL(2u, offsets[12]);
+    CHECK(indices == std::vector<uint32_t>({21, 22}));
+}
+
+// Тесты для BinaryReader и BinaryWriter (реальный модуль из client/)
+
+// Двоичный файл VCB1 из заголовка и 32-битных полей (количество и размеры)
+// с 64-битными значениями
+struct RawBinaryFile {
+    std::string bytes = std::string(BinaryFormat::magic, sizeof(BinaryFormat::magic));
+
+    RawBinaryFile& field(uint32_t value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+    RawBinaryFile& value(int64_t value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+};
+
+// Сообщение исключения чтения всех векторов файла; без исключения — пустая строка
+std::string binaryReadError(const std::string& path, size_t& readVectors) {
+    readVectors = 0;
+    try {
+        BinaryReader reader(path);
+        VectorBatch batch(reader.type());
+        while (reader.readNext(batch)) {
+            ++readVectors;
+        }
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+TEST(BinaryFormat_RoundTrip) {
+    std::string path = "binary_format_test.bin";
+    VectorParser parser;
+    VectorBatch source(ElementType::Int32);
+    parser.parseVector("1 -2 3", 1, source);
+    parser.parseVector("", 2, source);
+    parser.parseVector("2147483647", 3, source);
+
+    BinaryWriter writer(path, ElementType::Int32);
+    for (size_t i = 0; i < source.size(); ++i) {
+        writer.write(source[i]);
+    }
+    writer.finish();
+    CHECK(BinaryFormat::isBinaryFile(path));
+
+    BinaryReader reader(path);
+    CHECK(reader.type() == ElementType::Int32);
+    CHECK_EQUAL(3u, reader.count());
+    VectorBatch batch(ElementType::Int32);
+    while (reader.readNext(batch)) {
+    }
+    CHECK_EQUAL(3u, batch.size());
+    CHECK_EQUAL(3u, batch[0].size);
+    CHECK_EQUAL(-2, batch[0].values<int32_t>()[1]);
+    CHECK_EQUAL(0u, batch[1].size);
+    CHECK_EQUAL(INT32_MAX, batch[2].values<int32_t>()[0]);
+    std::remove(path.c_str());
+}
+
+TEST(BinaryReader_RejectsSizeBeyondFile) {
+    std::string path = "binary_format_test.bin";
+    size_t readVectors = 0;
+
+    // Повреждённое поле размера второго вектора: ошибка до выделения памяти
+    writeTextFile(path, RawBinaryFile().field(2).field(2).value(5).value(6).field(0x7fffffff).value(7).bytes);
+    CHECK_EQUAL(std::string("Truncated or corrupt binary vector file at vector 2: size 2147483647 "
+                            "exceeds the rest of the file"),
+                binaryReadError(path, readVectors));
+    CHECK_EQUAL(1u, readVectors);
+
+    // Обрезанный файл: размер на одно значение больше оставшегося
+    writeTextFile(path, RawBinaryFile().field(1).field(3).value(5).value(6).bytes);
+    CHECK_EQUAL(std::string("Truncated or corrupt binary vector file at vector 1: size 3 exceeds the rest of the file"),
+                binaryReadError(path, readVectors));
+
+    // Файл кончился на поле размера
+    writeTextFile(path, RawBinaryFile().field(2).field(1).value(5).bytes + std::string(2, '\0'));
+    CHECK_EQUAL(std::string("Truncated binary vector file at vector 2"), binaryReadError(path, readVectors));
+    CHECK_EQUAL(1u, readVectors);
+
+    writeTextFile(path, RawBinaryFile().field(2).field(1).value(5).field(0).bytes);
+    CHECK_EQUAL(std::string(""), binaryReadError(path, readVectors));
+    CHECK_EQUAL(2u, readVectors);
+    std::remove(path.c_str());
+}
+
+TEST(BinaryReader_RejectsCountBeyondFile) {
+    std::string path = "binary_format_test.bin";
+    size_t readVectors = 0;
+    writeTextFile(path, RawBinaryFile().field(0xffffffff).field(0).bytes);
+    CHECK_EQUAL(std::string("Truncated or corrupt binary vector file: binary_format_test.bin: count 4294967295 "
+                            "exceeds the file size"),
+                binaryReadError(path, readVectors));
+
+    writeTextFile(path, "VCB");
+    CHECK_EQUAL(std::string("Not a binary vector file: binary_format_test.bin"), binaryReadError(path, readVectors));
+    std::remove(path.c_str());
+}
+
 // Главная функция для запуска тестов
 int main() {
     return UnitTest::RunAllTests();
@@ -0,0 +1,336 @@
+#include "AsyncSession.h"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+
+namespace {
+// Источник не опрашивается, пока неотправленных данных больше порога
+const size_t flushThreshold = 256 * 1024;
+// Размер одного чтения из сокета
+const size_t readChunk = 64 * 1024;
+}
+
+AsyncSession::AsyncSession(const std::string& serverAddress, int serverPort, Authenticator authenticator)
+    : serverAddress(serverAddress), serverPort(serverPort), authenticator(std::move(authenticator)), socketFd(-1),
+      tcp(true), currentState(State::Closed), outHead(0), hasJob(false), jobCount(0), sent(0), received(0), window(1),
+      starved(false), readBuffer(readChunk), connectTimeoutMs(0), authTimeoutMs(0), responseTimeoutMs(0),
+      monitor(nullptr), elementType(ElementType::Int64), resultWidth(sizeof(int64_t)) {}
+
+AsyncSession::~AsyncSession() {
+    close();
+}
+
+void AsyncSession::close() {
+    if (socketFd != -1) {
+        ::close(socketFd);
+        socketFd = -1;
+    }
+    currentState = State::Closed;
+    sendTimes.clear();
+}
+
+void AsyncSession::setTimeouts(int connectMs, int authMs, int responseMs) {
+    connectTimeoutMs = std::max(0, connectMs);
+    authTimeoutMs = std::max(0, authMs);
+    responseTimeoutMs = std::max(0, responseMs);
+}
+
+AsyncSession::Clock::time_point AsyncSession::deadline() const {
+    int limit = 0;
+    Clock::time_point from = phaseStart;
+    switch (currentState) {
+        case State::Connecting:
+            limit = connectTimeoutMs;
+            break;
+        case State::ReceivingSalt:
+        case State::ReceivingReply:
+            limit = authTimeoutMs;
+            break;
+        case State::Transferring:
+            if (received < sent) {
+                limit = responseTimeoutMs;
+                from = lastProgress;
+            }
+            break;
+        default:
+            break;
+    }
+    if (limit == 0) {
+        return Clock::time_point::max();
+    }
+    return from + std::chrono::milliseconds(limit);
+}
+
+void AsyncSession::checkDeadline(Clock::time_point now) const {
+    if (now < deadline()) {
+        return;
+    }
+    switch (currentState) {
+        case State::Connecting:
+            throw TimeoutError("Timed out connecting to server after " + std::to_string(connectTimeoutMs) + " ms");
+        case State::ReceivingSalt:
+        case State::ReceivingReply:
+            throw TimeoutError("Authentication timed out after " + std::to_string(authTimeoutMs) + " ms");
+        default:
+            throw TimeoutError("No response from server within " + std::to_string(responseTimeoutMs) + " ms");
+    }
+}
+
+void AsyncSession::start() {
+    sockaddr_storage serverAddr;
+    socklen_t addrLength = resolveServerAddress(serverAddress, serverPort, serverAddr);
+    tcp = serverAddr.ss_family == AF_INET;
+
+    socketFd = socket(serverAddr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd == -1) {
+        throw std::runtime_error("Failed to create socket");
+    }
+
+    currentState = State::Connecting;
+    phaseStart = Clock::now();
+    if (connect(socketFd, reinterpret_cast<sockaddr*>(&serverAddr), addrLength) == 0) {
+        finishConnect();
+    } else if (errno != EINPROGRESS) {
+        throw std::runtime_error(std::string("Failed to connect to server: ") + std::strerror(errno));
+    }
+}
+
+void AsyncSession::finishConnect() {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+        throw std::runtime_error(std::string("Failed to connect to server: ") + std::strerror(error));
+    }
+
+    if (tcp) {
+        int noDelay = 1;
+        setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+
+    // Первое сообщение протокола — имя пользователя
+    static const char username[] = "user";
+    append(username, sizeof(username) - 1);
+    currentState = State::ReceivingSalt;
+    phaseStart = Clock::now();
+}
+
+void AsyncSession::assign(uint32_t count, Source source, Sink sink, unsigned window) {
+    if (hasJob) {
+        throw std::logic_error("Session already has a job");
+    }
+    this->jobCount = count;
+    this->source = std::move(source);
+    this->sink = std::move(sink);
+    this->window = window == 0 ? 1 : window;
+    hasJob = true;
+    if (currentState == State::Ready) {
+        beginJob();
+    }
+}
+
+void AsyncSession::beginJob() {
+    append(&jobCount, sizeof(jobCount));
+    sent = 0;
+    received = 0;
+    starved = false;
+    sendTimes.clear();
+    currentState = State::Transferring;
+    if (jobCount == 0) {
+        hasJob = false;
+        currentState = State::Ready;
+        return;
+    }
+    fillOutput();
+}
+
+bool AsyncSession::peerClosed() const {
+    if (socketFd == -1 || !inBuffer.empty()) {
+        return true;
+    }
+    pollfd descriptor{socketFd, POLLIN, 0};
+    return poll(&descriptor, 1, 0) != 0;
+}
+
+bool AsyncSession::wantsRead() const {
+    switch (currentState) {
+        case State::ReceivingSalt:
+        case State::ReceivingReply:
+            return true;
+        case State::Transferring:
+            return received < sent;
+        default:
+            return false;
+    }
+}
+
+void AsyncSession::advance(bool readable, bool writable, bool error) {
+    if (currentState == State::Closed) {
+        throw std::runtime_error("Session is closed");
+    }
+    if (currentState == State::Connecting) {
+        if (!writable && !error) {
+            return;
+        }
+        finishConnect();
+    } else if (error) {
+        int code = 0;
+        socklen_t length = sizeof(code);
+        getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &code, &length);
+        throw std::runtime_error(std::string("Connection error: ") + std::strerror(code));
+    }
+
+    if (readable) {
+        readInput();
+        consumeInput();
+    }
+    fillOutput();
+    // Сокет почти всегда готов к записи — не ждём отдельного события
+    if (writable || outHead < outBuffer.size()) {
+        writeOutput();
+    }
+}
+
+void AsyncSession::pump() {
+    if (currentState == State::Transferring && starved) {
+        starved = false;
+        fillOutput();
+        writeOutput();
+    }
+}
+
+void AsyncSession::append(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    outBuffer.insert(outBuffer.end(), bytes, bytes + size);
+}
+
+void AsyncSession::fillOutput() {
+    if (currentState != State::Transferring || starved) {
+        return;
+    }
+    VectorView vec{};
+    Clock::time_point now{};
+    while (sent < jobCount && sent - received < window && outBuffer.size() - outHead < flushThreshold) {
+        Pull pull = source(vec);
+        if (pull == Pull::Wait) {
+            starved = true;
+            return;
+        }
+        if (pull == Pull::End) {
+            throw std::runtime_error("Input ended after " + std::to_string(sent) + " of " + std::to_string(jobCount) +
+                                     " vectors");
+        }
+        uint32_t vectorSize = vec.size;
+        append(&vectorSize, sizeof(vectorSize));
+        append(vec.data, vec.bytes());
+        // Векторы одного заполнения буфера уходят вместе — одна отметка времени
+        if ((monitor || received == sent) && now == Clock::time_point()) {
+            now = Clock::now();
+        }
+        if (received == sent) {
+            lastProgress = now;
+        }
+        if (monitor) {
+            sendTimes.push_back(now);
+        }
+        ++sent;
+    }
+}
+
+void AsyncSession::writeOutput() {
+    while (outHead < outBuffer.size()) {
+        ssize_t written = send(socketFd, outBuffer.data() + outHead, outBuffer.size() - outHead, MSG_NOSIGNAL);
+        ++counters.sendCalls;
+        if (written > 0) {
+            counters.bytesSent += written;
+            outHead += written;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            throw std::runtime_error(std::string("Failed to send data: ") + std::strerror(errno));
+        }
+    }
+
+    if (outHead == outBuffer.size()) {
+        outBuffer.clear();
+        outHead = 0;
+    } else if (outHead >= flushThreshold) {
+        outBuffer.erase(outBuffer.begin(), outBuffer.begin() + outHead);
+        outHead = 0;
+    }
+}
+
+void AsyncSession::readInput() {
+    while (true) {
+        ssize_t got = recv(socketFd, readBuffer.data(), readBuffer.size(), 0);
+        ++counters.recvCalls;
+        if (got > 0) {
+            counters.bytesReceived += got;
+            inBuffer.insert(inBuffer.end(), readBuffer.data(), readBuffer.data() + got);
+            if (static_cast<size_t>(got) < readBuffer.size()) {
+                return;
+            }
+            continue;
+        }
+        if (got == 0) {
+            throw std::runtime_error("Server closed the connection");
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error(std::string("Failed to receive data: ") + std::strerror(errno));
+        }
+    }
+}
+
+void AsyncSession::consumeInput() {
+    size_t head = 0;
+    size_t available = inBuffer.size();
+
+    if (currentState == State::ReceivingSalt && available - head >= 16) {
+        std::string salt(inBuffer.data() + head, 16);
+        head += 16;
+        std::string response = authenticator(salt);
+        append(response.data(), response.size());
+        currentState = State::ReceivingReply;
+    }
+    if (currentState == State::ReceivingReply && available - head >= 2) {
+        if (std::string(inBuffer.data() + head, 2) != "OK") {
+            throw std::runtime_error("Authentication failed");
+        }
+        head += 2;
+        currentState = State::Ready;
+        if (hasJob) {
+            beginJob();
+        }
+    }
+    if (currentState == State::Transferring && received < sent && available - head >= resultWidth) {
+        lastProgress = Clock::now();
+    }
+    while (currentState == State::Transferring && received < sent && available - head >= resultWidth) {
+        int64_t result = decodeSlot(inBuffer.data() + head, elementType);
+        head += resultWidth;
+        if (monitor) {
+            monitor->record(std::chrono::duration<double, std::milli>(lastProgress - sendTimes.front()).count());
+            sendTimes.pop_front();
+        }
+        sink(received++, result);
+        if (received == jobCount) {
+            hasJob = false;
+            source = nullptr;
+            sink = nullptr;
+            currentState = State::Ready;
+        }
+    }
+    if (head < available && (currentState == State::Ready || currentState == State::Transferring) &&
+        received == sent) {
+        throw std::runtime_error("Unexpected data from server");
+    }
+
+    inBuffer.erase(inBuffer.begin(), inBuffer.begin() + head);
+}
@@ -0,0 +1,123 @@
+#ifndef ASYNC_SESSION_H
+#define ASYNC_SESSION_H
+
+#include "Communicator.h"
+#include "VectorBatch.h"
+#include "LatencyMonitor.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// Соединение с сервером на неблокирующем сокете для цикла событий
+// (EventEngine). Подключение, аутентификация, отправка векторов и приём
+// результатов — переходы конечного автомата, которые выполняет advance по
+// готовности сокета; ни один вызов не блокируется, поэтому один поток
+// обслуживает сколько угодно сессий. После задания сессия возвращается
+// в состояние Ready и может принять следующее.
+class AsyncSession {
+public:
+    enum class State { Connecting, ReceivingSalt, ReceivingReply, Ready, Transferring, Closed };
+
+    // Результат обращения к источнику векторов
+    enum class Pull { Vector, Wait, End };
+    // Неблокирующий источник: Wait — вектора пока нет, сессия
+    // возобновит отправку при следующем вызове pump.
+    // Представление должно оставаться действительным до следующего вызова.
+    using Source = std::function<Pull(VectorView& vec)>;
+    using Sink = std::function<void(size_t index, int64_t result)>;
+    // Ответ на соль сервера (хэш соли и пароля)
+    using Authenticator = std::function<std::string(const std::string& salt)>;
+    using Clock = std::chrono::steady_clock;
+
+    AsyncSession(const std::string& serverAddress, int serverPort, Authenticator authenticator);
+    ~AsyncSession();
+
+    AsyncSession(const AsyncSession&) = delete;
+    AsyncSession& operator=(const AsyncSession&) = delete;
+
+    // Ограничения в миллисекундах (0 — без ограничения): подключение,
+    // аутентификация целиком и ожидание очередного результата при
+    // векторах в полёте. Задаются до start
+    void setTimeouts(int connectMs, int authMs, int responseMs);
+    // Учёт времени ответа на каждый вектор (nullptr — без учёта)
+    void setMonitor(LatencyMonitor* monitor) { this->monitor = monitor; }
+    // Тип результатов: сервер отвечает значением той же ширины, что и элементы
+    void setElementType(ElementType type) { elementType = type; resultWidth = elementWidth(type); }
+
+    // Неблокирующее подключение; дальнейший ход — через advance
+    void start();
+
+    // Задание: count векторов из source, не более window без результата.
+    // Можно назначить до окончания аутентификации — отправка начнётся после неё
+    void assign(uint32_t count, Source source, Sink sink, unsigned window);
+
+    // Обработка готовности сокета; ошибки протокола и сети — исключения
+    void advance(bool readable, bool writable, bool error);
+
+    // Повторное обращение к источнику после Wait
+    void pump();
+
+    // Ближайший срок текущего этапа (Clock::time_point::max() — не ограничен)
+    Clock::time_point deadline() const;
+    // TimeoutError, если срок текущего этапа к моменту now истёк
+    void checkDeadline(Clock::time_point now) const;
+
+    int fd() const { return socketFd; }
+    State state() const { return currentState; }
+    bool idle() const { return currentState == State::Ready && !hasJob && outHead == outBuffer.size(); }
+    bool wantsRead() const;
+    bool wantsWrite() const { return outHead < outBuffer.size() || currentState == State::Connecting; }
+    const Communicator::Stats& stats() const { return counters; }
+
+    // Простаивающая сессия закрыта сервером или непригодна (см. Communicator)
+    bool peerClosed() const;
+
+    void close();
+
+private:
+    std::string serverAddress;
+    int serverPort;
+    Authenticator authenticator;
+    int socketFd;
+    bool tcp;
+    State currentState;
+    Communicator::Stats counters;
+
+    std::vector<char> outBuffer;    // Ещё не отправленные данные начиная с outHead
+    size_t outHead;
+    std::vector<char> inBuffer;     // Принятые, но не разобранные данные
+
+    bool hasJob;
+    uint32_t jobCount;
+    uint32_t sent;
+    uint32_t received;
+    unsigned window;
+    bool starved;                   // Источник ответил Wait
+    Source source;
+    Sink sink;
+    std::vector<char> readBuffer;
+
+    int connectTimeoutMs;
+    int authTimeoutMs;
+    int responseTimeoutMs;
+    LatencyMonitor* monitor;
+    ElementType elementType;
+    size_t resultWidth;
+    Clock::time_point phaseStart;       // Начало подключения или аутентификации
+    Clock::time_point lastProgress;     // Последний результат или первый вектор в полёте
+    std::deque<Clock::time_point> sendTimes;    // Время отправки векторов в полёте (при учёте)
+
+    void finishConnect();
+    void beginJob();
+    void fillOutput();
+    void writeOutput();
+    void readInput();
+    void consumeInput();
+    void append(const void* data, size_t size);
+};
+
+#endif // ASYNC_SESSION_H
@@ -0,0 +1,124 @@
+#include "BinaryFormat.h"
+#include <cstring>
+#include <limits>
+#include <sys/stat.h>
+
+bool BinaryFormat::isBinaryFile(const std::string& filename) {
+    struct stat st {};
+    if (stat(filename.c_str(), &st) == -1 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+
+    std::ifstream in(filename, std::ios::binary);
+    char header[sizeof(magic)] = {};
+    in.read(header, sizeof(header));
+    return in.gcount() == sizeof(header) &&
+           (std::memcmp(header, magic, sizeof(magic)) == 0 || std::memcmp(header, typedMagic, sizeof(magic)) == 0);
+}
+
+BinaryReader::BinaryReader(const std::string& filename)
+    : elementType(ElementType::Int64), total(0), consumed(0), remaining(0) {
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    struct stat st {};
+    if (stat(filename.c_str(), &st) == -1) {
+        throw std::runtime_error("Failed to stat file: " + filename);
+    }
+
+    char header[sizeof(BinaryFormat::magic)];
+    file.read(header, sizeof(header));
+    if (file && std::memcmp(header, BinaryFormat::typedMagic, sizeof(header)) == 0) {
+        uint32_t type = 0;
+        file.read(reinterpret_cast<char*>(&type), sizeof(type));
+        if (type > static_cast<uint32_t>(ElementType::Double)) {
+            throw std::runtime_error("Unknown element type in binary vector file: " + filename);
+        }
+        elementType = static_cast<ElementType>(type);
+    } else if (!file || std::memcmp(header, BinaryFormat::magic, sizeof(header)) != 0) {
+        throw std::runtime_error("Not a binary vector file: " + filename);
+    }
+    file.read(reinterpret_cast<char*>(&total), sizeof(total));
+    if (!file) {
+        throw std::runtime_error("Truncated binary vector file: " + filename);
+    }
+    remaining = static_cast<uint64_t>(st.st_size) - static_cast<uint64_t>(file.tellg());
+    // У каждого вектора есть хотя бы поле размера; по count резервируется память
+    if (static_cast<uint64_t>(total) * sizeof(uint32_t) > remaining) {
+        throw std::runtime_error("Truncated or corrupt binary vector file: " + filename + ": count " +
+                                 std::to_string(total) + " exceeds the file size");
+    }
+}
+
+bool BinaryReader::readNext(VectorBatch& batch) {
+    if (consumed == total) {
+        return false;
+    }
+
+    uint32_t size = 0;
+    file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!file) {
+        throw std::runtime_error("Truncated binary vector file at vector " + std::to_string(consumed + 1));
+    }
+    remaining -= sizeof(size);
+
+    dispatchElement(elementType, [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        // Размер из файла проверяется до выделения памяти под вектор
+        if (static_cast<uint64_t>(size) * sizeof(T) > remaining) {
+            throw std::runtime_error("Truncated or corrupt binary vector file at vector " +
+                                     std::to_string(consumed + 1) + ": size " + std::to_string(size) +
+                                     " exceeds the rest of the file");
+        }
+        remaining -= static_cast<uint64_t>(size) * sizeof(T);
+        std::vector<T>& values = batch.openVector<T>();
+        size_t base = values.size();
+        values.resize(base + size);
+        file.read(reinterpret_cast<char*>(values.data() + base), size * sizeof(T));
+        if (!file) {
+            values.resize(base);
+            throw std::runtime_error("Truncated binary vector file at vector " + std::to_string(consumed + 1));
+        }
+    });
+    batch.closeVector();
+    ++consumed;
+    return true;
+}
+
+BinaryWriter::BinaryWriter(const std::string& filename, ElementType type) : countOffset(0), written(0) {
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    if (type == ElementType::Int64) {
+        file.write(BinaryFormat::magic, sizeof(BinaryFormat::magic));
+    } else {
+        uint32_t code = static_cast<uint32_t>(type);
+        file.write(BinaryFormat::typedMagic, sizeof(BinaryFormat::typedMagic));
+        file.write(reinterpret_cast<const char*>(&code), sizeof(code));
+    }
+    countOffset = file.tellp();
+    file.write(reinterpret_cast<const char*>(&written), sizeof(written));
+}
+
+void BinaryWriter::write(VectorView vec) {
+    if (written == std::numeric_limits<uint32_t>::max() || vec.size > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too many values for the binary format");
+    }
+
+    uint32_t size = vec.size;
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(vec.data), vec.bytes());
+    ++written;
+}
+
+void BinaryWriter::finish() {
+    file.seekp(countOffset);
+    file.write(reinterpret_cast<const char*>(&written), sizeof(written));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write binary vector file");
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+#include "VectorBatch.h"
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+
+// Двоичный формат входных данных (числа в порядке байтов хоста):
+//
+//   char     magic[4] = {'V', 'C', 'B', '1'} — элементы int64_t,
+//            или {'V', 'C', 'B', '2'}, за которой uint32_t type — тип
+//            элементов (числовое значение ElementType)
+//   uint32_t count                      — количество векторов
+//   count раз:
+//     uint32_t size                     — количество элементов вектора
+//     T        values[size]
+//
+// После заголовка содержимое файла побайтно совпадает с потоком, который
+// клиент передаёт серверу, поэтому при отправке разбор текста не нужен.
+// Сигнатура не может встретиться в начале текстового файла с числами.
+namespace BinaryFormat {
+    const char magic[4] = {'V', 'C', 'B', '1'};
+    const char typedMagic[4] = {'V', 'C', 'B', '2'};
+
+    // Проверка сигнатуры; для каналов и устройств всегда false,
+    // чтобы не потерять прочитанные байты
+    bool isBinaryFile(const std::string& filename);
+}
+
+// Последовательное чтение векторов из двоичного файла
+class BinaryReader {
+    std::ifstream file;
+    ElementType elementType;
+    uint32_t total;
+    uint32_t consumed;
+    uint64_t remaining;     // Непрочитанные байты файла: размеры векторов проверяются по ним
+
+public:
+    explicit BinaryReader(const std::string& filename);
+
+    ElementType type() const { return elementType; }
+    uint32_t count() const { return total; }
+
+    // Дописывает следующий вектор в batch (того же типа, что и файл);
+    // false, если векторы закончились. Размер вектора, не помещающийся
+    // в остаток файла, — ошибка (файл обрезан или повреждён)
+    bool readNext(VectorBatch& batch);
+};
+
+// Запись векторов в двоичный файл; количество векторов дописывается в finish().
+// Файлы с int64_t пишутся в исходном формате VCB1
+class BinaryWriter {
+    std::ofstream file;
+    std::streamoff countOffset;
+    uint32_t written;
+
+public:
+    explicit BinaryWriter(const std::string& filename, ElementType type = ElementType::Int64);
+
+    void write(VectorView vec);
+    void finish();
+};
+
+#endif // BINARY_FORMAT_H
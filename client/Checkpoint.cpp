@@ -0,0 +1,159 @@
+#include "Checkpoint.h"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char magic[4] = {'V', 'C', 'K', '2'};
+// Формат без типа элементов: ячейки всегда int64
+const char untypedMagic[4] = {'V', 'C', 'K', '1'};
+
+// Поля выровнены естественным образом, заполнителей нет
+struct Header {
+    char magic[4];
+    uint32_t done;
+    uint64_t inputSize;
+    int64_t inputMtime;
+    uint32_t type;
+    uint32_t reserved;
+};
+static_assert(sizeof(Header) == 32, "unexpected checkpoint header layout");
+
+// Признаки входного файла, по которым контрольная точка к нему привязана
+void describeInput(const std::string& inputFile, uint64_t& size, int64_t& mtime) {
+    struct stat st {};
+    if (stat(inputFile.c_str(), &st) == -1) {
+        throw std::runtime_error("Failed to open file: " + inputFile);
+    }
+    size = st.st_size;
+    mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+void writeAll(int fd, const void* data, size_t size, off_t offset, const std::string& path) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write checkpoint " + path + ": " + std::strerror(errno));
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+}
+
+// Счётчик в заголовке продвигается только после того, как данные на диске
+void syncAll(int fd, const std::string& path) {
+    if (fdatasync(fd) == -1) {
+        throw std::runtime_error("Failed to sync checkpoint " + path + ": " + std::strerror(errno));
+    }
+}
+
+} // namespace
+
+std::string Checkpoint::pathFor(const std::string& outputFile) {
+    return outputFile + ".ckpt";
+}
+
+bool Checkpoint::load(const std::string& path, const std::string& inputFile, ElementType type,
+                      std::vector<int64_t>& results) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        if (errno == ENOENT) {
+            return false;
+        }
+        throw std::runtime_error("Failed to open checkpoint " + path + ": " + std::strerror(errno));
+    }
+
+    Header header{};
+    bool valid = pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+                 std::memcmp(header.magic, magic, sizeof(magic)) == 0;
+    if (!valid && std::memcmp(header.magic, untypedMagic, sizeof(untypedMagic)) == 0) {
+        close(fd);
+        throw std::runtime_error("Checkpoint " + path + " was written by an older client, remove it to start over");
+    }
+    // Число результатов сверяется с размером файла до выделения памяти:
+    // испорченный заголовок не должен приводить к выделению гигабайтов
+    struct stat info;
+    if (valid) {
+        valid = fstat(fd, &info) == 0 &&
+                sizeof(Header) + static_cast<uint64_t>(header.done) * sizeof(int64_t) <=
+                    static_cast<uint64_t>(info.st_size);
+    }
+    if (valid) {
+        results.resize(header.done);
+        size_t bytes = results.size() * sizeof(int64_t);
+        valid = pread(fd, results.data(), bytes, sizeof(header)) == static_cast<ssize_t>(bytes);
+    }
+    close(fd);
+    if (!valid) {
+        throw std::runtime_error("Corrupted checkpoint: " + path);
+    }
+
+    uint64_t size;
+    int64_t mtime;
+    describeInput(inputFile, size, mtime);
+    if (size != header.inputSize || mtime != header.inputMtime) {
+        throw std::runtime_error("Input file changed since checkpoint " + path + " was written");
+    }
+    if (header.type != static_cast<uint32_t>(type)) {
+        ElementType saved = static_cast<ElementType>(header.type);
+        std::string savedName = header.type <= static_cast<uint32_t>(ElementType::Double) ? elementTypeName(saved)
+                                                                                           : "unknown";
+        throw std::runtime_error("Checkpoint " + path + " was written for element type " + savedName + ", not " +
+                                 elementTypeName(type));
+    }
+    return true;
+}
+
+Checkpoint::Checkpoint(const std::string& path, const std::string& inputFile, ElementType type,
+                       const std::vector<int64_t>& completed)
+    : path(path), fd(-1), savedCount(0) {
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.type = static_cast<uint32_t>(type);
+    describeInput(inputFile, header.inputSize, header.inputMtime);
+
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to create checkpoint " + path + ": " + std::strerror(errno));
+    }
+    writeAll(fd, &header, sizeof(header), 0, path);
+    update(completed.data(), completed.size());
+}
+
+Checkpoint::~Checkpoint() {
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+void Checkpoint::update(const int64_t* results, size_t done) {
+    if (fd == -1 || done <= savedCount) {
+        return;
+    }
+    writeAll(fd, results + savedCount, (done - savedCount) * sizeof(int64_t),
+             sizeof(Header) + savedCount * sizeof(int64_t), path);
+    syncAll(fd, path);
+
+    uint32_t count = done;
+    writeAll(fd, &count, sizeof(count), offsetof(Header, done), path);
+    syncAll(fd, path);
+    savedCount = done;
+}
+
+void Checkpoint::remove() {
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+    unlink(path.c_str());
+}
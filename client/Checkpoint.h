@@ -0,0 +1,54 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "ElementType.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Контрольная точка длительной обработки — файл <выходной файл>.ckpt
+// (числа в порядке байтов хоста):
+//
+//   char     magic[4] = {'V', 'C', 'K', '2'}
+//   uint32_t done                       — число векторов с полученным результатом
+//   uint64_t inputSize                  — размер входного файла
+//   int64_t  inputMtime                 — время изменения входного файла (нс)
+//   uint32_t type                       — тип элементов (числовое значение ElementType)
+//   uint32_t reserved = 0
+//   int64_t  results[done]              — их результаты (ячейки ElementType.h), по порядку
+//
+// Результаты только дописываются, а done обновляется после fdatasync данных,
+// поэтому прерванная запись не портит уже сохранённую часть.
+class Checkpoint {
+public:
+    static std::string pathFor(const std::string& outputFile);
+
+    // Чтение контрольной точки; false, если файла нет. Если входной файл
+    // изменился после её записи или она записана для другого типа
+    // элементов, продолжать нельзя — исключение
+    static bool load(const std::string& path, const std::string& inputFile, ElementType type,
+                     std::vector<int64_t>& results);
+
+    // Создание файла с уже известными результатами (пустыми — при первом запуске)
+    Checkpoint(const std::string& path, const std::string& inputFile, ElementType type,
+               const std::vector<int64_t>& completed);
+    ~Checkpoint();
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    // Сохранение первых done результатов; записываются только новые
+    void update(const int64_t* results, size_t done);
+    size_t saved() const { return savedCount; }
+
+    // Удаление файла после успешной записи результатов
+    void remove();
+
+private:
+    std::string path;
+    int fd;
+    size_t savedCount;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,105 @@
+#include "ChunkedParser.h"
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Разбор строк диапазона; номера строк отсчитываются от начала диапазона
+void parseRange(const VectorParser& parser, std::string_view text, VectorBatch& batch) {
+    size_t pos = 0;
+    size_t lineNumber = 0;
+    while (pos < text.size()) {
+        const char* start = text.data() + pos;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', text.size() - pos));
+        size_t length = newline ? static_cast<size_t>(newline - start) : text.size() - pos;
+        parser.parseVector(std::string_view(start, length), ++lineNumber, batch);
+        pos += length + 1;
+    }
+}
+
+size_t countNewlines(std::string_view text) {
+    size_t count = 0;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while ((p = static_cast<const char*>(std::memchr(p, '\n', end - p))) != nullptr) {
+        ++count;
+        ++p;
+    }
+    return count;
+}
+
+} // namespace
+
+ChunkedParser::ChunkedParser(unsigned threads, size_t minChunkBytes)
+    : threads(threads), minChunkBytes(std::max<size_t>(minChunkBytes, 1)) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+VectorBatch ChunkedParser::parse(std::string_view text, ElementType type) const {
+    VectorParser parser;
+    size_t chunks = std::min<size_t>(threads, std::max<size_t>(1, text.size() / minChunkBytes));
+    if (chunks <= 1) {
+        VectorBatch batch(type);
+        parseRange(parser, text, batch);
+        return batch;
+    }
+
+    // Границы диапазонов сдвигаются вперёд до ближайшего конца строки
+    std::vector<size_t> bounds(1, 0);
+    for (size_t i = 1; i < chunks; ++i) {
+        size_t pos = std::max(bounds.back(), text.size() * i / chunks);
+        const char* newline = static_cast<const char*>(std::memchr(text.data() + pos, '\n', text.size() - pos));
+        bounds.push_back(newline ? static_cast<size_t>(newline - text.data()) + 1 : text.size());
+    }
+    bounds.push_back(text.size());
+
+    std::vector<VectorBatch> parts(chunks, VectorBatch(type));
+    std::vector<std::exception_ptr> errors(chunks);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        workers.emplace_back([&, i]() {
+            try {
+                parseRange(parser, text.substr(bounds[i], bounds[i + 1] - bounds[i]), parts[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Первая по порядку ошибка; номер строки пересчитывается от начала файла
+    for (size_t i = 0; i < chunks; ++i) {
+        if (!errors[i]) {
+            continue;
+        }
+        try {
+            std::rethrow_exception(errors[i]);
+        } catch (const ParseError& error) {
+            size_t linesBefore = countNewlines(text.substr(0, bounds[i]));
+            throw ParseError(error.detail(), linesBefore + error.line(), error.column());
+        }
+    }
+
+    size_t vectors = 0;
+    size_t values = 0;
+    for (const auto& part : parts) {
+        vectors += part.size();
+        values += part.totalValues();
+    }
+
+    VectorBatch batch(type);
+    batch.reserve(vectors, values);
+    for (auto& part : parts) {
+        batch.append(part);
+        part = VectorBatch(type);
+    }
+    return batch;
+}
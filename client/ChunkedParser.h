@@ -0,0 +1,25 @@
+#ifndef CHUNKED_PARSER_H
+#define CHUNKED_PARSER_H
+
+#include "VectorParser.h"
+#include "VectorBatch.h"
+#include <string_view>
+#include <cstddef>
+
+// Многопоточный разбор текста с векторами: текст делится на диапазоны
+// по границам строк, каждый диапазон разбирается в свою пачку, затем
+// пачки склеиваются в исходном порядке строк.
+class ChunkedParser {
+    unsigned threads;
+    size_t minChunkBytes;
+
+public:
+    // threads == 0 — по числу доступных ядер
+    explicit ChunkedParser(unsigned threads, size_t minChunkBytes = 1 << 20);
+
+    unsigned threadCount() const { return threads; }
+
+    VectorBatch parse(std::string_view text, ElementType type = ElementType::Int64) const;
+};
+
+#endif // CHUNKED_PARSER_H
@@ -1,7 +1,36 @@
 #include "Communicator.h"
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+
+// Константы нулевого копирования могут отсутствовать в старых заголовках glibc
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
+namespace {
+// Ёмкость буфера приёма (степень двойки)
+const size_t receiveCapacity = 64 * 1024;
+}
 
 Communicator::Communicator(const std::string& serverAddress, int serverPort)
-    : socketFd(-1), serverAddress(serverAddress), serverPort(serverPort) {}
+    : socketFd(-1), serverAddress(serverAddress), serverPort(serverPort), timeoutMs(0),
+      recvBuffer(receiveCapacity), recvHead(0), recvTail(0),
+      zeroCopyEnabled(false), zeroCopyIssued(0), zeroCopyCompleted(0) {}
 
 Communicator::~Communicator() {
     if (socketFd != -1) {
@@ -9,22 +38,111 @@ Communicator::~Communicator() {
     }
 }
 
+socklen_t resolveServerAddress(const std::string& address, int port, sockaddr_storage& storage) {
+    storage = sockaddr_storage{};
+    static const std::string unixPrefix = "unix:";
+    if (address.compare(0, unixPrefix.size(), unixPrefix) == 0) {
+        std::string path = address.substr(unixPrefix.size());
+        sockaddr_un* local = reinterpret_cast<sockaddr_un*>(&storage);
+        if (path.empty() || path.size() >= sizeof(local->sun_path)) {
+            throw std::runtime_error("Invalid server address");
+        }
+        local->sun_family = AF_UNIX;
+        std::memcpy(local->sun_path, path.c_str(), path.size() + 1);
+        return sizeof(sockaddr_un);
+    }
+
+    sockaddr_in* inet = reinterpret_cast<sockaddr_in*>(&storage);
+    inet->sin_family = AF_INET;
+    inet->sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &inet->sin_addr) <= 0) {
+        throw std::runtime_error("Invalid server address");
+    }
+    return sizeof(sockaddr_in);
+}
+
 void Communicator::connectToServer() {
-    socketFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_storage serverAddr;
+    socklen_t addrLength = resolveServerAddress(serverAddress, serverPort, serverAddr);
+
+    socketFd = socket(serverAddr.ss_family, SOCK_STREAM, 0);
     if (socketFd == -1) {
         throw std::runtime_error("Failed to create socket");
     }
 
-    sockaddr_in serverAddr{};
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(serverPort);
-    if (inet_pton(AF_INET, serverAddress.c_str(), &serverAddr.sin_addr) <= 0) {
-        throw std::runtime_error("Invalid server address");
+    if (timeoutMs <= 0) {
+        if (connect(socketFd, reinterpret_cast<sockaddr*>(&serverAddr), addrLength) == -1) {
+            throw std::runtime_error("Failed to connect to server");
+        }
+    } else {
+        // Подключение с ограничением: неблокирующий connect и ожидание в poll
+        int flags = fcntl(socketFd, F_GETFL);
+        fcntl(socketFd, F_SETFL, flags | O_NONBLOCK);
+        if (connect(socketFd, reinterpret_cast<sockaddr*>(&serverAddr), addrLength) == -1) {
+            if (errno != EINPROGRESS) {
+                throw std::runtime_error("Failed to connect to server");
+            }
+            pollfd descriptor{socketFd, POLLOUT, 0};
+            int ready;
+            do {
+                ready = poll(&descriptor, 1, timeoutMs);
+            } while (ready == -1 && errno == EINTR);
+            if (ready == 0) {
+                throw TimeoutError("Timed out connecting to server after " + std::to_string(timeoutMs) + " ms");
+            }
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (ready == -1 || error != 0) {
+                throw std::runtime_error("Failed to connect to server");
+            }
+        }
+        fcntl(socketFd, F_SETFL, flags);
+        setTimeout(timeoutMs);
+    }
+
+    // Мелкие сообщения клиент объединяет сам, задержка Nagle только мешает
+    if (serverAddr.ss_family == AF_INET) {
+        int noDelay = 1;
+        setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
     }
+}
+
+void Communicator::shutdown() {
+    if (socketFd != -1) {
+        ::shutdown(socketFd, SHUT_RDWR);
+    }
+}
+
+void Communicator::setTimeout(int milliseconds) {
+    timeoutMs = milliseconds > 0 ? milliseconds : 0;
+    if (socketFd != -1) {
+        // Отправка ограничивается таймаутом сокета, приём — ожиданием в poll
+        timeval limit{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+        setsockopt(socketFd, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+    }
+}
+
+void Communicator::waitReadable() {
+    if (timeoutMs <= 0) {
+        return;
+    }
+    pollfd descriptor{socketFd, POLLIN, 0};
+    int ready;
+    do {
+        ready = poll(&descriptor, 1, timeoutMs);
+    } while (ready == -1 && errno == EINTR);
+    if (ready == 0) {
+        throw TimeoutError("No response from server within " + std::to_string(timeoutMs) + " ms");
+    }
+}
 
-    if (connect(socketFd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) == -1) {
-        throw std::runtime_error("Failed to connect to server");
+bool Communicator::peerClosed() const {
+    if (socketFd == -1 || buffered() > 0) {
+        return true;
     }
+    pollfd descriptor{socketFd, POLLIN, 0};
+    return poll(&descriptor, 1, 0) != 0;
 }
 
 void Communicator::sendMessage(const std::string& message) {
@@ -32,24 +150,210 @@ void Communicator::sendMessage(const std::string& message) {
 }
 
 void Communicator::sendMessage(const char* data, size_t size) {
-    if (send(socketFd, data, size, 0) == -1) {
-        throw std::runtime_error("Failed to send data");
+    iovec iov{const_cast<char*>(data), size};
+    sendv(&iov, 1);
+}
+
+void Communicator::sendv(iovec* iov, size_t count) {
+    while (count > 0) {
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = std::min<size_t>(count, IOV_MAX);
+        ssize_t sent = sendmsg(socketFd, &message, MSG_NOSIGNAL);
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                throw TimeoutError("Server did not accept data within " + std::to_string(timeoutMs) + " ms");
+            }
+            throw std::runtime_error("Failed to send data");
+        }
+        ++counters.sendCalls;
+        counters.bytesSent += sent;
+
+        // Пропуск полностью отправленных буферов и сдвиг частично отправленного
+        size_t left = static_cast<size_t>(sent);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
     }
 }
 
+bool Communicator::enableZeroCopy() {
+    int enable = 1;
+    zeroCopyEnabled = setsockopt(socketFd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+    return zeroCopyEnabled;
+}
+
+void Communicator::sendZeroCopy(const char* data, size_t size) {
+    if (!zeroCopyEnabled) {
+        sendMessage(data, size);
+        return;
+    }
+
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t result = send(socketFd, data + sent, size - sent, MSG_ZEROCOPY | MSG_NOSIGNAL);
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Исчерпан лимит закреплённой памяти — остаток отправляется обычным способом
+            if (errno == ENOBUFS) {
+                sendMessage(data + sent, size - sent);
+                break;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                throw TimeoutError("Server did not accept data within " + std::to_string(timeoutMs) + " ms");
+            }
+            throw std::runtime_error("Failed to send data");
+        }
+        ++counters.sendCalls;
+        ++counters.zeroCopySends;
+        ++zeroCopyIssued;
+        counters.bytesSent += result;
+        counters.zeroCopyBytes += result;
+        sent += static_cast<size_t>(result);
+    }
+
+    waitZeroCopyCompletions();
+}
+
+void Communicator::waitZeroCopyCompletions() {
+    // Каждое уведомление подтверждает диапазон номеров [ee_info, ee_data]
+    while (zeroCopyCompleted != zeroCopyIssued) {
+        pollfd pfd{socketFd, 0, 0};
+        int ready = poll(&pfd, 1, timeoutMs > 0 ? timeoutMs : -1);
+        if (ready == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to wait for zero-copy completion");
+        }
+        if (ready == 0) {
+            throw TimeoutError("No zero-copy completion within " + std::to_string(timeoutMs) + " ms");
+        }
+
+        char control[128];
+        msghdr message{};
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (recvmsg(socketFd, &message, MSG_ERRQUEUE) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Соединение закрыто, а уведомлений больше не будет
+            if (errno == EAGAIN && !(pfd.revents & (POLLHUP | POLLNVAL))) {
+                continue;
+            }
+            throw std::runtime_error("Failed to read zero-copy completion");
+        }
+
+        for (cmsghdr* cm = CMSG_FIRSTHDR(&message); cm != nullptr; cm = CMSG_NXTHDR(&message, cm)) {
+            auto* error = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cm));
+            if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            zeroCopyCompleted += error->ee_data - error->ee_info + 1;
+            if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                ++counters.zeroCopyCopied;
+            }
+        }
+    }
+}
+
+size_t Communicator::receiveSome(char* buffer, size_t size) {
+    waitReadable();
+    while (true) {
+        ssize_t bytesRead = recv(socketFd, buffer, size, 0);
+        if (bytesRead > 0) {
+            ++counters.recvCalls;
+            counters.bytesReceived += bytesRead;
+            return static_cast<size_t>(bytesRead);
+        }
+        if (bytesRead == 0) {
+            throw std::runtime_error("Connection closed by server");
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error("Failed to receive data");
+        }
+    }
+}
+
+size_t Communicator::fillReceiveBuffer() {
+    // Свободное место кольца может состоять из двух частей
+    size_t capacity = recvBuffer.size();
+    size_t tail = recvTail % capacity;
+    size_t space = capacity - buffered();
+    size_t first = std::min(space, capacity - tail);
+    iovec iov[2] = {
+        {recvBuffer.data() + tail, first},
+        {recvBuffer.data(), space - first},
+    };
+
+    waitReadable();
+    while (true) {
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = iov[1].iov_len > 0 ? 2 : 1;
+        ssize_t bytesRead = recvmsg(socketFd, &message, 0);
+        if (bytesRead > 0) {
+            ++counters.recvCalls;
+            counters.bytesReceived += bytesRead;
+            recvTail += bytesRead;
+            return static_cast<size_t>(bytesRead);
+        }
+        if (bytesRead == 0) {
+            throw std::runtime_error("Connection closed by server");
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error("Failed to receive data");
+        }
+    }
+}
+
+size_t Communicator::takeBuffered(char* buffer, size_t size) {
+    size_t capacity = recvBuffer.size();
+    size_t count = std::min(size, buffered());
+    size_t head = recvHead % capacity;
+    size_t first = std::min(count, capacity - head);
+    std::memcpy(buffer, recvBuffer.data() + head, first);
+    std::memcpy(buffer + first, recvBuffer.data(), count - first);
+    recvHead += count;
+    return count;
+}
+
 std::string Communicator::receiveMessage(size_t bufferSize) {
-    std::string buffer(bufferSize, '\0');
-    ssize_t bytesRead = recv(socketFd, buffer.data(), bufferSize, 0);
-    if (bytesRead == -1) {
-        throw std::runtime_error("Failed to receive data");
+    if (buffered() == 0) {
+        fillReceiveBuffer();
     }
-    buffer.resize(bytesRead);
+    std::string buffer(std::min(bufferSize, buffered()), '\0');
+    takeBuffered(buffer.data(), buffer.size());
     return buffer;
 }
 
 void Communicator::receiveMessage(char* buffer, size_t size) {
-    ssize_t bytesRead = recv(socketFd, buffer, size, 0);
-    if (bytesRead != static_cast<ssize_t>(size)) {
-        throw std::runtime_error("Failed to receive the expected amount of data");
+    try {
+        size_t received = takeBuffered(buffer, size);
+        while (received < size) {
+            // Крупные сообщения читаются напрямую, минуя буфер
+            if (size - received >= recvBuffer.size()) {
+                received += receiveSome(buffer + received, size - received);
+            } else {
+                fillReceiveBuffer();
+                received += takeBuffered(buffer + received, size - received);
+            }
+        }
+    } catch (const TimeoutError& error) {
+        throw TimeoutError(std::string("Failed to receive the expected amount of data: ") + error.what());
+    } catch (const std::runtime_error& error) {
+        throw std::runtime_error(std::string("Failed to receive the expected amount of data: ") + error.what());
     }
 }
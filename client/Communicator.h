@@ -3,16 +3,66 @@
 
 #include <string>
 #include <stdexcept>
+#include <cstdint>
+#include <vector>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 
+// Адрес сервера: IPv4 и порт или "unix:/путь" — сокет Unix для сервера на
+// той же машине (порт не используется). Протокол поверх обоих одинаков.
+// Возвращает длину адреса; некорректный адрес — исключение
+socklen_t resolveServerAddress(const std::string& address, int port, sockaddr_storage& storage);
+
+// Сервер не ответил за отведённое время (см. Communicator::setTimeout)
+class TimeoutError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 class Communicator {
+public:
+    // Счётчики системных вызовов и переданных байт
+    struct Stats {
+        uint64_t sendCalls = 0;
+        uint64_t recvCalls = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t zeroCopySends = 0;     // Вызовов sendmsg с MSG_ZEROCOPY
+        uint64_t zeroCopyBytes = 0;
+        uint64_t zeroCopyCopied = 0;    // Завершений, при которых ядро всё же скопировало данные
+    };
+
 private:
     int socketFd;
     std::string serverAddress;
     int serverPort;
+    Stats counters;
+    int timeoutMs;
+
+    void waitReadable();
+
+    // Кольцевой буфер приёма: за один вызов recv читается всё, что доступно,
+    // а запросы фиксированной длины обслуживаются из буфера.
+    // recvHead и recvTail растут монотонно, позиция в буфере — по модулю ёмкости.
+    std::vector<char> recvBuffer;
+    size_t recvHead;
+    size_t recvTail;
+
+    size_t buffered() const { return recvTail - recvHead; }
+    size_t fillReceiveBuffer();
+    size_t takeBuffered(char* buffer, size_t size);
+    size_t receiveSome(char* buffer, size_t size);
+
+    // Нулевое копирование: номера уведомлений, выданных и подтверждённых ядром
+    bool zeroCopyEnabled;
+    uint32_t zeroCopyIssued;
+    uint32_t zeroCopyCompleted;
+
+    void waitZeroCopyCompletions();
 
 public:
     Communicator(const std::string& serverAddress, int serverPort);
@@ -20,13 +70,44 @@ public:
 
     void connectToServer();
 
+    // Ограничение каждого блокирующего ожидания (подключение, приём,
+    // отправка) в миллисекундах, 0 — без ограничения. При истечении —
+    // TimeoutError. Задаётся до начала обмена, не из нескольких потоков
+    void setTimeout(int milliseconds);
+    int timeout() const { return timeoutMs; }
+
+    // Прерывание обмена в обоих направлениях (разблокирует ждущие send/recv)
+    void shutdown();
+
+    // Проверка простаивающего соединения: сервер закрыл его или прислал
+    // что-то вне протокола, и продолжать обмен по нему нельзя
+    bool peerClosed() const;
+
     // Отправка данных
     void sendMessage(const std::string& message);
     void sendMessage(const char* data, size_t size);
 
-    // Получение данных
+    // Отправка нескольких буферов минимальным числом вызовов sendmsg;
+    // частичная запись дописывается, массив iov при этом изменяется
+    void sendv(iovec* iov, size_t count);
+
+    // Включение SO_ZEROCOPY; false, если ядро или сокет его не поддерживают
+    bool enableZeroCopy();
+    bool zeroCopyAvailable() const { return zeroCopyEnabled; }
+
+    // Отправка без копирования в ядро (MSG_ZEROCOPY). Возвращается только
+    // после уведомлений из очереди ошибок сокета о том, что ядро закончило
+    // работу со страницами, поэтому буфер можно сразу освобождать.
+    void sendZeroCopy(const char* data, size_t size);
+
+    // Получение данных: строка — всё доступное (не более bufferSize);
+    // буфер — ровно size байт, с дочитыванием при частичном приёме
     std::string receiveMessage(size_t bufferSize = 1024);
     void receiveMessage(char* buffer, size_t size);
+
+    // Отправка и приём могут идти из разных потоков; счётчики каждого
+    // направления изменяет только свой поток
+    const Stats& stats() const { return counters; }
 };
 
 #endif // COMMUNICATOR_H
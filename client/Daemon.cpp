@@ -0,0 +1,175 @@
+#include "Daemon.h"
+#include "ResultWriter.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+// Без SA_RESTART сигнал прерывает accept, и цикл успевает завершиться
+void installSignalHandlers() {
+    struct sigaction action{};
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+// Максимальный размер запроса: два пути и разделители
+const size_t maxRequest = 2 * PATH_MAX + 2;
+
+void reply(int clientFd, const std::string& message) {
+    size_t offset = 0;
+    while (offset < message.size()) {
+        ssize_t written = send(clientFd, message.data() + offset, message.size() - offset, MSG_NOSIGNAL);
+        if (written <= 0) {
+            if (written == -1 && errno == EINTR) {
+                continue;
+            }
+            return;     // Клиент ушёл, не дождавшись ответа
+        }
+        offset += written;
+    }
+}
+
+// Принимает ли кто-то соединения на сокете: false только при ECONNREFUSED
+// (сокет остался от завершившегося процесса)
+bool socketAlive(const sockaddr_un& address) {
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe == -1) {
+        throw std::runtime_error(std::string("Failed to create socket: ") + std::strerror(errno));
+    }
+    int result = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    int error = errno;
+    close(probe);
+    if (result == 0) {
+        return true;
+    }
+    if (error == ECONNREFUSED) {
+        return false;
+    }
+    throw std::runtime_error(std::string("Failed to check daemon socket ") + address.sun_path + ": " +
+                             std::strerror(error));
+}
+
+} // namespace
+
+Daemon::Daemon(SessionPool& pool, Logger& logger) : pool(pool), logger(logger), listenFd(-1) {}
+
+Daemon::~Daemon() {
+    if (listenFd != -1) {
+        close(listenFd);
+    }
+    if (!boundPath.empty()) {
+        unlink(boundPath.c_str());
+    }
+}
+
+void Daemon::serve(const std::string& socketPath) {
+    installSignalHandlers();
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is too long: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd == -1) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    // Сокет, оставшийся от прежнего запуска, заменяется, а сокет
+    // работающего процесса — нет
+    struct stat info;
+    if (stat(socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        if (socketAlive(address)) {
+            throw std::runtime_error("Daemon already running on " + socketPath);
+        }
+        unlink(socketPath.c_str());
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        throw std::runtime_error("Failed to bind daemon socket " + socketPath + ": " + std::strerror(errno));
+    }
+    boundPath = socketPath;
+    chmod(socketPath.c_str(), 0600);
+    if (listen(listenFd, 16) == -1) {
+        throw std::runtime_error(std::string("Failed to listen on daemon socket: ") + std::strerror(errno));
+    }
+
+    // Соединения прогреваются до первого задания
+    pool.open();
+    logger.info("Daemon listening on " + socketPath);
+
+    while (!stopRequested) {
+        int clientFd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Failed to accept job: ") + std::strerror(errno));
+        }
+        handle(clientFd);
+        close(clientFd);
+    }
+    logger.info("Daemon stopped");
+}
+
+void Daemon::handle(int clientFd) {
+    // Зависший клиент не должен останавливать очередь заданий
+    timeval timeout{5, 0};
+    setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[4096];
+    while (std::count(request.begin(), request.end(), '\n') < 2 && request.size() <= maxRequest) {
+        ssize_t got = recv(clientFd, buffer, sizeof(buffer), 0);
+        if (got == -1 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+        request.append(buffer, got);
+    }
+
+    size_t first = request.find('\n');
+    size_t second = first == std::string::npos ? first : request.find('\n', first + 1);
+    if (second == std::string::npos || first == 0 || second == first + 1) {
+        reply(clientFd, "ERROR Malformed job request\n");
+        return;
+    }
+    std::string inputFile = request.substr(0, first);
+    std::string outputFile = request.substr(first + 1, second - first - 1);
+
+    try {
+        size_t vectors = process(inputFile, outputFile);
+        reply(clientFd, "OK " + std::to_string(vectors) + "\n");
+    } catch (const std::exception& ex) {
+        logger.error("job " + inputFile + ": " + ex.what());
+        reply(clientFd, std::string("ERROR ") + ex.what() + "\n");
+    }
+}
+
+size_t Daemon::process(const std::string& inputFile, const std::string& outputFile) {
+    // Соединения, закрытые сервером за время простоя, открываются заново
+    pool.open();
+    ResultWriter output(outputFile, pool.elementType());
+    std::vector<int64_t> results = pool.run(inputFile, {}, nullptr, &output);
+    output.finish();
+    logger.info("Job done: " + inputFile + " -> " + outputFile + " (" + std::to_string(results.size()) + " vectors)");
+    return results.size();
+}
@@ -0,0 +1,33 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include "SessionPool.h"
+#include <string>
+
+// Фоновый режим (client --daemon): соединения с сервером открываются один
+// раз и остаются аутентифицированными, а задания приходят через локальный
+// сокет Unix. Задания выполняются по одному в порядке поступления.
+//
+// Протокол сокета (его использует vclient-submit):
+//   запрос  — "<входной файл>\n<выходной файл>\n" (абсолютные пути);
+//   ответ   — "OK <число векторов>\n" или "ERROR <сообщение>\n".
+class Daemon {
+public:
+    // Состояние фонового режима и ошибки заданий выводятся в logger
+    Daemon(SessionPool& pool, Logger& logger);
+    ~Daemon();
+
+    // Приём заданий до SIGINT или SIGTERM
+    void serve(const std::string& socketPath);
+
+private:
+    SessionPool& pool;
+    Logger& logger;
+    int listenFd;
+    std::string boundPath;
+
+    void handle(int clientFd);
+    size_t process(const std::string& inputFile, const std::string& outputFile);
+};
+
+#endif // DAEMON_H
@@ -1,26 +1,258 @@
 #include "DataReader.h"
+#include "Decompressor.h"
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-DataReader::DataReader(const std::string& filename) {
-    file.open(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file");
+namespace {
+const size_t bufferChunk = 1 << 20;
+}
+
+DataReader::DataReader(const std::string& filename, Mode mode)
+    : fd(-1), mapped(false), finished(false), mapData(nullptr), mapSize(0), mapPos(0),
+      bufferStart(0), bufferEnd(0), sourceExhausted(false) {
+    fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to stat file: " + filename);
+    }
+
+    // Сигнатура сжатого файла: у обычного файла читается без сдвига позиции,
+    // у канала прочитанные байты остаются в буфере
+    char head[4];
+    size_t headSize = 0;
+    if (S_ISREG(st.st_mode)) {
+        ssize_t got = pread(fd, head, sizeof(head), 0);
+        headSize = got > 0 ? static_cast<size_t>(got) : 0;
+    } else {
+        buffer.resize(bufferChunk);
+        while (bufferEnd < sizeof(head)) {
+            size_t got = readSource(buffer.data() + bufferEnd, sizeof(head) - bufferEnd);
+            if (got == 0) {
+                sourceExhausted = true;
+                break;
+            }
+            bufferEnd += got;
+        }
+        headSize = bufferEnd;
+        std::memcpy(head, buffer.data(), headSize);
+    }
+
+    Decompressor::Format format = Decompressor::detect(head, headSize);
+    if (format != Decompressor::Format::None) {
+        if (mode == Mode::Mapped) {
+            close(fd);
+            throw std::runtime_error("Compressed file cannot be mapped: " + filename);
+        }
+        try {
+            decompressor = std::make_unique<Decompressor>(fd, format, std::string(buffer.data(), bufferEnd));
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        bufferEnd = 0;
+        sourceExhausted = false;
+        buffer.resize(bufferChunk);
+        return;
+    }
+
+    if (mode != Mode::Buffered && S_ISREG(st.st_mode)) {
+        mapSize = static_cast<size_t>(st.st_size);
+        if (mapSize == 0) {
+            mapped = true;
+        } else {
+            void* data = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                madvise(data, mapSize, MADV_SEQUENTIAL);
+                mapData = static_cast<const char*>(data);
+                mapped = true;
+            }
+        }
+    }
+
+    if (!mapped) {
+        if (mode == Mode::Mapped) {
+            close(fd);
+            throw std::runtime_error("Failed to map file: " + filename);
+        }
+        mapSize = 0;
+        buffer.resize(std::max(buffer.size(), bufferChunk));
+    }
+}
+
+size_t DataReader::readSource(char* data, size_t size) {
+    if (decompressor) {
+        return decompressor->read(data, size);
+    }
+
+    while (true) {
+        ssize_t got = read(fd, data, size);
+        if (got >= 0) {
+            return static_cast<size_t>(got);
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error("Failed to read file");
+        }
+    }
+}
+
+bool DataReader::fillBuffer() {
+    // Сдвигаем непрочитанный остаток в начало, при необходимости растим буфер
+    if (bufferStart > 0) {
+        std::memmove(buffer.data(), buffer.data() + bufferStart, bufferEnd - bufferStart);
+        bufferEnd -= bufferStart;
+        bufferStart = 0;
+    }
+    if (bufferEnd == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    size_t got = readSource(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+    if (got == 0) {
+        sourceExhausted = true;
+        return false;
+    }
+    bufferEnd += got;
+    return true;
+}
+
+bool DataReader::nextLine(std::string_view& line) {
+    if (finished) {
+        return false;
+    }
+
+    if (mapped) {
+        if (mapPos >= mapSize) {
+            finished = true;
+            return false;
+        }
+        const char* start = mapData + mapPos;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', mapSize - mapPos));
+        size_t length = newline ? static_cast<size_t>(newline - start) : mapSize - mapPos;
+        line = std::string_view(start, length);
+        mapPos += length + 1;
+        return true;
+    }
+
+    // Поиск '\n' продолжается с места, где он остановился в прошлый раз
+    size_t scanned = bufferStart;
+    while (true) {
+        const char* start = buffer.data() + bufferStart;
+        const char* newline = static_cast<const char*>(
+            std::memchr(buffer.data() + scanned, '\n', bufferEnd - scanned));
+        if (newline) {
+            line = std::string_view(start, newline - start);
+            bufferStart = newline - buffer.data() + 1;
+            return true;
+        }
+        if (sourceExhausted) {
+            if (bufferStart == bufferEnd) {
+                finished = true;
+                return false;
+            }
+            line = std::string_view(start, bufferEnd - bufferStart);
+            bufferStart = bufferEnd;
+            return true;
+        }
+        size_t pending = bufferEnd - bufferStart;
+        fillBuffer();
+        scanned = pending;
     }
 }
 
 std::string DataReader::readNextLine() {
     std::string line;
-    if (std::getline(file, line)) {
-        return line;
+    readNextLine(line);
+    return line;
+}
+
+bool DataReader::readNextLine(std::string& line) {
+    std::string_view view;
+    if (!nextLine(view)) {
+        line.clear();
+        return false;
     }
-    return {};
+    line.assign(view.data(), view.size());
+    return true;
 }
 
 bool DataReader::eof() const {
-    return file.eof();
+    return finished;
 }
 
 DataReader::~DataReader() {
-    if (file.is_open()) {
-        file.close();
+    decompressor.reset();
+    if (mapData) {
+        munmap(const_cast<char*>(mapData), mapSize);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+std::unique_ptr<DataReader> DataReader::openCounted(const std::string& filename, size_t& lines) {
+    auto reader = std::make_unique<DataReader>(filename);
+    if (reader->isMapped()) {
+        std::string_view data = reader->contents();
+        lines = std::count(data.begin(), data.end(), '\n');
+        if (!data.empty() && data.back() != '\n') {
+            ++lines;
+        }
+        return reader;
+    }
+
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir && *dir ? dir : "/tmp") + "/vclient-spool-XXXXXX";
+    int out = mkstemp(path.data());
+    if (out == -1) {
+        throw std::runtime_error("Failed to create temporary file for " + filename + ": " + std::strerror(errno));
+    }
+    auto writeAll = [&](const std::string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t got = write(out, data.data() + done, data.size() - done);
+            if (got == -1 && errno == EINTR) {
+                continue;
+            }
+            if (got == -1) {
+                throw std::runtime_error("Failed to write temporary file " + path + ": " + std::strerror(errno));
+            }
+            done += static_cast<size_t>(got);
+        }
+    };
+
+    try {
+        std::string pending;
+        std::string_view line;
+        lines = 0;
+        while (reader->nextLine(line)) {
+            pending.append(line.data(), line.size());
+            pending += '\n';
+            ++lines;
+            if (pending.size() >= bufferChunk) {
+                writeAll(pending);
+                pending.clear();
+            }
+        }
+        writeAll(pending);
+        reader = std::make_unique<DataReader>(path);
+    } catch (...) {
+        close(out);
+        unlink(path.c_str());
+        throw;
     }
+    // Копия открыта (и отображена) читателем: имя больше не нужно
+    close(out);
+    unlink(path.c_str());
+    return reader;
 }
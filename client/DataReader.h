@@ -1,18 +1,72 @@
 #ifndef DATA_READER_H
 #define DATA_READER_H
 
-#include <fstream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
 #include <stdexcept>
 
+class Decompressor;
+
+// Построчное чтение файла. Обычные файлы отображаются в память (mmap),
+// и строки выдаются как string_view прямо из страничного кэша; для каналов,
+// устройств и т.п. используется буферизованное чтение через read().
+// Файлы, сжатые gzip/zstd, распознаются по сигнатуре и распаковываются
+// на лету в отдельном потоке (см. Decompressor).
 class DataReader {
-    std::ifstream file;
+public:
+    enum class Mode { Auto, Mapped, Buffered };
+
+private:
+    int fd;
+    bool mapped;
+    bool finished;
+
+    // Отображённый файл
+    const char* mapData;
+    size_t mapSize;
+    size_t mapPos;
+
+    // Буферизованное чтение: данные в buffer[bufferStart, bufferEnd)
+    std::vector<char> buffer;
+    size_t bufferStart;
+    size_t bufferEnd;
+    bool sourceExhausted;
+
+    std::unique_ptr<Decompressor> decompressor;
+
+    bool fillBuffer();
+    size_t readSource(char* data, size_t size);
 
 public:
-    explicit DataReader(const std::string& filename);
+    explicit DataReader(const std::string& filename, Mode mode = Mode::Auto);
+    DataReader(const DataReader&) = delete;
+    DataReader& operator=(const DataReader&) = delete;
+
     std::string readNextLine();
+    bool readNextLine(std::string& line);
+
+    // Следующая строка без копирования (без символа '\n').
+    // В режиме mmap строка действительна всё время жизни объекта,
+    // в буферизованном — до следующего вызова.
+    bool nextLine(std::string_view& line);
+
     bool eof() const;
+    bool isMapped() const { return mapped; }
+    bool isCompressed() const { return decompressor != nullptr; }
+
+    // Всё содержимое отображённого файла (пусто в буферизованном режиме)
+    std::string_view contents() const { return std::string_view(mapData, mapped ? mapSize : 0); }
     ~DataReader();
+
+    // Открытие файла с подсчётом строк (в смысле std::getline) за один
+    // проход по источнику, без загрузки файла в память. Обычный несжатый
+    // файл считается по отображению. Канал, FIFO и сжатый файл прочитать
+    // второй раз нельзя (или дорого), поэтому их строки при подсчёте
+    // копируются во временный файл в $TMPDIR (по умолчанию /tmp), и
+    // возвращается читатель этой копии; копия удаляется вместе с ним
+    static std::unique_ptr<DataReader> openCounted(const std::string& filename, size_t& lines);
 };
 
 #endif // DATA_READER_H
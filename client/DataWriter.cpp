@@ -1,18 +1,196 @@
 #include "DataWriter.h"
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 
-DataWriter::DataWriter(const std::string& filename) {
-    file.open(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file for writing");
+bool DataWriter::FlushPolicy::parse(const std::string& text, FlushPolicy& policy) {
+    if (text == "none" || text == "fsync") {
+        policy.mode = text == "none" ? Mode::None : Mode::Sync;
+        policy.every = 0;
+        return true;
     }
+    size_t colon = text.find(':');
+    std::string kind = text.substr(0, colon);
+    if (colon == std::string::npos || (kind != "lines" && kind != "ms")) {
+        return false;
+    }
+    try {
+        size_t used = 0;
+        unsigned long long every = std::stoull(text.substr(colon + 1), &used);
+        if (every == 0 || used != text.size() - colon - 1) {
+            return false;
+        }
+        policy.mode = kind == "lines" ? Mode::Lines : Mode::Interval;
+        policy.every = every;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
 }
 
-void DataWriter::writeLine(const std::string& line) {
-    file << line << std::endl;
+DataWriter::DataWriter(const std::string& filename) : DataWriter(filename, FlushPolicy()) {}
+
+DataWriter::DataWriter(const std::string& filename, FlushPolicy policy, size_t bufferSize)
+    : fd(-1), policy(policy), bufferSize(bufferSize), maxBuffered(4 * bufferSize), pendingLines(0), requested(0),
+      completed(0), handoff(false), closing(false) {
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open file for writing: " + filename + ": " + std::strerror(errno));
+    }
+    front.reserve(bufferSize);
+    back.reserve(bufferSize);
+    worker = std::thread([this]() { run(); });
 }
 
 DataWriter::~DataWriter() {
-    if (file.is_open()) {
-        file.close();
+    try {
+        close();
+    } catch (const std::exception&) {
+    }
+}
+
+void DataWriter::rethrowError() {
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void DataWriter::writeLine(const std::string& line) {
+    std::unique_lock<std::mutex> lock(mutex);
+    rethrowError();
+    if (closing) {
+        throw std::runtime_error("Write to a closed file");
+    }
+    // Поток записи отстал: ждём, пока он примет буфер
+    space.wait(lock, [&] { return front.size() < maxBuffered || error; });
+    rethrowError();
+    front += line;
+    front += '\n';
+    ++pendingLines;
+    bool due = front.size() >= bufferSize ||
+               (policy.mode == FlushPolicy::Mode::Lines && pendingLines >= policy.every);
+    if (due && !handoff) {
+        handoff = true;
+        ready.notify_one();
+    }
+}
+
+void DataWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    rethrowError();
+    uint64_t id = ++requested;
+    ready.notify_one();
+    space.wait(lock, [&] { return completed >= id || error; });
+    rethrowError();
+}
+
+void DataWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing) {
+            return;
+        }
+        closing = true;
+    }
+    ready.notify_one();
+    worker.join();
+    int syncResult = 0;
+    int syncError = 0;
+    if (policy.mode == FlushPolicy::Mode::Sync && !error) {
+        syncResult = fsync(fd);
+        syncError = errno;
+    }
+    ::close(fd);
+    fd = -1;
+    rethrowError();
+    if (syncResult == -1) {
+        throw std::runtime_error(std::string("Failed to sync file: ") + std::strerror(syncError));
+    }
+}
+
+// Поток записи забирает front целиком: это выполняет и запрос передачи,
+// и все запросы flush, сделанные до обмена
+void DataWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto wanted = [&] { return handoff || requested > completed || closing; };
+    while (true) {
+        if (policy.mode == FlushPolicy::Mode::Interval) {
+            ready.wait_for(lock, std::chrono::milliseconds(policy.every), wanted);
+        } else {
+            ready.wait(lock, wanted);
+        }
+        uint64_t target = requested;
+        if (front.empty()) {
+            handoff = false;
+            completed = target;
+            space.notify_all();
+            if (closing) {
+                return;
+            }
+            continue;
+        }
+
+        front.swap(back);
+        pendingLines = 0;
+        handoff = false;
+        space.notify_all();
+        // После ошибки строки отбрасываются: её получит вызывающий
+        bool failed = error != nullptr;
+        lock.unlock();
+        std::exception_ptr failure;
+        if (!failed) {
+            try {
+                writeAll(back);
+            } catch (...) {
+                failure = std::current_exception();
+            }
+        }
+        back.clear();
+        lock.lock();
+        if (failure && !error) {
+            error = failure;
+        }
+        completed = target;
+        space.notify_all();
+    }
+}
+
+void DataWriter::writeAll(const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Failed to write file: ") + std::strerror(errno));
+        }
+        written += result;
+    }
+}
+
+void writeResults(const std::string& outputFile, const std::vector<int64_t>& results, ElementType type) {
+    std::ofstream file(outputFile, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open output file: " + outputFile);
+    }
+
+    uint32_t numResults = results.size();
+    file.write(reinterpret_cast<const char*>(&numResults), sizeof(numResults));
+    if (type == ElementType::Int64) {
+        file.write(reinterpret_cast<const char*>(results.data()), results.size() * sizeof(int64_t));
+    } else {
+        // Ячейки сужаются до ширины типа
+        size_t width = elementWidth(type);
+        std::vector<char> encoded(results.size() * width);
+        for (size_t i = 0; i < results.size(); ++i) {
+            encodeSlot(results[i], type, encoded.data() + i * width);
+        }
+        file.write(encoded.data(), encoded.size());
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write output file: " + outputFile);
     }
 }
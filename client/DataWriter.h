@@ -1,17 +1,83 @@
 #ifndef DATA_WRITER_H
 #define DATA_WRITER_H
 
-#include <fstream>
+#include "ElementType.h"
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <cstdint>
+#include <cstddef>
 
+// Запись текстового файла по строкам без ожидания диска. Строки копятся
+// в одном из двух буферов; фоновый поток забирает заполненный буфер
+// (обмен буферов) и записывает его, пока вызывающий продолжает писать
+// в другой. Вызывающий ждёт, только если диск отстал больше чем на
+// maxBuffered байт. Когда данные передаются ядру, задаёт FlushPolicy.
+// Ошибка записи выдаётся исключением из следующего writeLine, flush или close.
 class DataWriter {
-    std::ofstream file;
-
 public:
+    struct FlushPolicy {
+        enum class Mode {
+            None,       // Только по заполнении буфера и при закрытии
+            Lines,      // Каждые every строк
+            Interval,   // Каждые every миллисекунд
+            Sync,       // Как None, при закрытии — fsync
+        };
+
+        Mode mode = Mode::None;
+        size_t every = 0;
+
+        // Разбор вида none, lines:N, ms:T или fsync
+        static bool parse(const std::string& text, FlushPolicy& policy);
+    };
+
     explicit DataWriter(const std::string& filename);
-    void writeLine(const std::string& line);
+    DataWriter(const std::string& filename, FlushPolicy policy, size_t bufferSize = 1 << 20);
+    // Закрывает файл; ошибки записи при этом не выдаются — для них close()
     ~DataWriter();
+
+    DataWriter(const DataWriter&) = delete;
+    DataWriter& operator=(const DataWriter&) = delete;
+
+    // Можно вызывать из нескольких потоков
+    void writeLine(const std::string& line);
+    // Ожидание записи всех строк в файл (без fsync)
+    void flush();
+    // Запись оставшихся строк, fsync для политики Sync, закрытие
+    void close();
+
+private:
+    int fd;
+    FlushPolicy policy;
+    size_t bufferSize;      // Буфер передаётся потоку записи по заполнении
+    size_t maxBuffered;     // Больше этого вызывающий ждёт поток записи
+
+    std::mutex mutex;
+    std::condition_variable ready;      // Для потока записи: есть что записать
+    std::condition_variable space;      // Для вызывающих: буфер принят или записан
+    std::string front;                  // Заполняется вызывающими
+    std::string back;                   // Записывается фоновым потоком
+    size_t pendingLines;                // Строк в front
+    uint64_t requested;                 // Номер последнего запроса flush
+    uint64_t completed;                 // Выполненные запросы flush (по номеру)
+    bool handoff;                       // front нужно передать потоку записи
+    bool closing;
+    std::exception_ptr error;
+    std::thread worker;
+
+    void run();
+    void writeAll(const std::string& data);
+    void rethrowError();
 };
 
+// Файл результатов: количество (uint32_t), затем результаты типа type
+// (elementWidth(type) байт каждый; results — ячейки, см. ElementType.h)
+void writeResults(const std::string& outputFile, const std::vector<int64_t>& results,
+                  ElementType type = ElementType::Int64);
+
 #endif // DATA_WRITER_H
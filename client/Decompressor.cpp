@@ -0,0 +1,261 @@
+#include "Decompressor.h"
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+const size_t inputChunk = 1 << 16;
+const size_t blockSize = 1 << 20;
+const size_t maxQueuedBlocks = 4;
+}
+
+Decompressor::Format Decompressor::detect(const char* data, size_t size) {
+    static const unsigned char gzipMagic[] = {0x1f, 0x8b};
+    static const unsigned char zstdMagic[] = {0x28, 0xb5, 0x2f, 0xfd};
+    if (size >= sizeof(gzipMagic) && std::memcmp(data, gzipMagic, sizeof(gzipMagic)) == 0) {
+        return Format::Gzip;
+    }
+    if (size >= sizeof(zstdMagic) && std::memcmp(data, zstdMagic, sizeof(zstdMagic)) == 0) {
+        return Format::Zstd;
+    }
+    return Format::None;
+}
+
+const char* Decompressor::formatName(Format format) {
+    switch (format) {
+        case Format::Gzip:
+            return "gzip";
+        case Format::Zstd:
+            return "zstd";
+        default:
+            return "none";
+    }
+}
+
+bool Decompressor::isSupported(Format format) {
+    switch (format) {
+#ifdef HAVE_ZLIB
+        case Format::Gzip:
+            return true;
+#endif
+#ifdef HAVE_ZSTD
+        case Format::Zstd:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+Decompressor::Decompressor(int fd, Format format, std::string prefix)
+    : fd(fd), format(format), prefix(std::move(prefix)), prefixPos(0), done(false), stopping(false),
+      currentPos(0) {
+    if (!isSupported(format)) {
+        throw std::runtime_error(std::string("Input is ") + formatName(format) +
+                                 "-compressed, but this build has no support for it");
+    }
+    worker = std::thread(&Decompressor::run, this);
+}
+
+Decompressor::~Decompressor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    spaceAvailable.notify_all();
+    worker.join();
+}
+
+void Decompressor::run() {
+    try {
+        if (format == Format::Gzip) {
+            inflateGzip();
+        } else {
+            inflateZstd();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    dataAvailable.notify_all();
+}
+
+size_t Decompressor::readInput(char* buffer, size_t size) {
+    if (prefixPos < prefix.size()) {
+        size_t count = std::min(size, prefix.size() - prefixPos);
+        std::memcpy(buffer, prefix.data() + prefixPos, count);
+        prefixPos += count;
+        return count;
+    }
+
+    while (true) {
+        ssize_t got = ::read(fd, buffer, size);
+        if (got >= 0) {
+            return static_cast<size_t>(got);
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error("Failed to read compressed input");
+        }
+    }
+}
+
+bool Decompressor::emit(std::vector<char>& block, size_t used) {
+    block.resize(used);
+    std::unique_lock<std::mutex> lock(mutex);
+    spaceAvailable.wait(lock, [&] { return stopping || blocks.size() < maxQueuedBlocks; });
+    if (stopping) {
+        return false;
+    }
+    blocks.push_back(std::move(block));
+    dataAvailable.notify_one();
+
+    block.assign(blockSize, 0);
+    return true;
+}
+
+void Decompressor::inflateGzip() {
+#ifdef HAVE_ZLIB
+    z_stream stream {};
+    // 15 + 32: окно 32 КБ, автоматическое распознавание заголовка gzip/zlib
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw std::runtime_error("Failed to initialize gzip decoder");
+    }
+    struct Guard {
+        z_stream& stream;
+        ~Guard() { inflateEnd(&stream); }
+    } guard{stream};
+
+    std::vector<char> input(inputChunk);
+    std::vector<char> block(blockSize);
+    size_t used = 0;
+    bool memberEnded = false;
+    while (true) {
+        if (stream.avail_in == 0) {
+            size_t got = readInput(input.data(), input.size());
+            if (got == 0) {
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(input.data());
+            stream.avail_in = static_cast<uInt>(got);
+        }
+        // Несколько gzip-потоков подряд (как у cat a.gz b.gz) читаются как один
+        if (memberEnded) {
+            inflateReset(&stream);
+            memberEnded = false;
+        }
+
+        stream.next_out = reinterpret_cast<Bytef*>(block.data() + used);
+        stream.avail_out = static_cast<uInt>(block.size() - used);
+        int ret = inflate(&stream, Z_NO_FLUSH);
+        used = block.size() - stream.avail_out;
+        if (ret == Z_STREAM_END) {
+            memberEnded = true;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            throw std::runtime_error(std::string("Corrupted gzip input: ") + (stream.msg ? stream.msg : "unknown error"));
+        }
+
+        if (used == block.size()) {
+            if (!emit(block, used)) {
+                return;
+            }
+            used = 0;
+        }
+    }
+
+    if (!memberEnded) {
+        throw std::runtime_error("Truncated gzip input");
+    }
+    if (used > 0) {
+        emit(block, used);
+    }
+#endif
+}
+
+void Decompressor::inflateZstd() {
+#ifdef HAVE_ZSTD
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (stream == nullptr) {
+        throw std::runtime_error("Failed to initialize zstd decoder");
+    }
+    struct Guard {
+        ZSTD_DStream* stream;
+        ~Guard() { ZSTD_freeDStream(stream); }
+    } guard{stream};
+    ZSTD_initDStream(stream);
+
+    std::vector<char> input(inputChunk);
+    std::vector<char> block(blockSize);
+    size_t used = 0;
+    size_t pending = 0;
+    bool inputEnded = false;
+    while (true) {
+        ZSTD_inBuffer in{input.data(), 0, 0};
+        if (!inputEnded) {
+            in.size = readInput(input.data(), input.size());
+            inputEnded = in.size == 0;
+        }
+
+        // Без новых входных данных декодер может ещё выдавать накопленный вывод
+        bool flushed = false;
+        while (in.pos < in.size || (inputEnded && !flushed)) {
+            ZSTD_outBuffer out{block.data() + used, block.size() - used, 0};
+            pending = ZSTD_decompressStream(stream, &out, &in);
+            if (ZSTD_isError(pending)) {
+                throw std::runtime_error(std::string("Corrupted zstd input: ") + ZSTD_getErrorName(pending));
+            }
+            used += out.pos;
+            if (used == block.size()) {
+                if (!emit(block, used)) {
+                    return;
+                }
+                used = 0;
+            } else if (inputEnded) {
+                flushed = true;
+            }
+        }
+        if (inputEnded) {
+            break;
+        }
+    }
+
+    if (pending != 0) {
+        throw std::runtime_error("Truncated zstd input");
+    }
+    if (used > 0) {
+        emit(block, used);
+    }
+#endif
+}
+
+size_t Decompressor::read(char* buffer, size_t size) {
+    if (currentPos == current.size()) {
+        std::unique_lock<std::mutex> lock(mutex);
+        dataAvailable.wait(lock, [&] { return !blocks.empty() || done; });
+        if (blocks.empty()) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return 0;
+        }
+        current = std::move(blocks.front());
+        blocks.pop_front();
+        currentPos = 0;
+        spaceAvailable.notify_one();
+    }
+
+    size_t count = std::min(size, current.size() - currentPos);
+    std::memcpy(buffer, current.data() + currentPos, count);
+    currentPos += count;
+    return count;
+}
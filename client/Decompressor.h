@@ -0,0 +1,62 @@
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <cstddef>
+
+// Потоковая распаковка gzip/zstd в отдельном потоке. Распакованные данные
+// передаются читателю блоками через ограниченную очередь, поэтому распаковка
+// идёт параллельно с разбором и отправкой. Поддержка форматов зависит от
+// сборки: HAVE_ZLIB (gzip) и HAVE_ZSTD (zstd).
+class Decompressor {
+public:
+    enum class Format { None, Gzip, Zstd };
+
+    // Определение формата по сигнатуре в начале файла
+    static Format detect(const char* data, size_t size);
+    static const char* formatName(Format format);
+    static bool isSupported(Format format);
+
+    // prefix — уже прочитанные из fd байты начала потока
+    Decompressor(int fd, Format format, std::string prefix);
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+    ~Decompressor();
+
+    // Чтение распакованных данных; 0 — конец потока
+    size_t read(char* buffer, size_t size);
+
+private:
+    int fd;
+    Format format;
+    std::string prefix;
+    size_t prefixPos;
+
+    std::mutex mutex;
+    std::condition_variable dataAvailable;
+    std::condition_variable spaceAvailable;
+    std::deque<std::vector<char>> blocks;
+    bool done;
+    bool stopping;
+    std::exception_ptr error;
+
+    std::vector<char> current;
+    size_t currentPos;
+
+    std::thread worker;
+
+    void run();
+    void inflateGzip();
+    void inflateZstd();
+    size_t readInput(char* buffer, size_t size);
+    bool emit(std::vector<char>& block, size_t used);
+};
+
+#endif // DECOMPRESSOR_H
@@ -0,0 +1,58 @@
+#include "ElementType.h"
+#include <sstream>
+#include <limits>
+
+const char* elementTypeName(ElementType type) {
+    switch (type) {
+        case ElementType::Int32:
+            return "int32";
+        case ElementType::UInt64:
+            return "uint64";
+        case ElementType::Double:
+            return "double";
+        default:
+            return "int64";
+    }
+}
+
+bool parseElementType(const std::string& name, ElementType& type) {
+    for (ElementType candidate : {ElementType::Int32, ElementType::Int64, ElementType::UInt64, ElementType::Double}) {
+        if (name == elementTypeName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t elementWidth(ElementType type) {
+    return dispatchElement(type, [](auto tag) { return sizeof(typename decltype(tag)::type); });
+}
+
+int64_t decodeSlot(const char* data, ElementType type) {
+    return dispatchElement(type, [data](auto tag) {
+        typename decltype(tag)::type value;
+        std::memcpy(&value, data, sizeof(value));
+        return toSlot(value);
+    });
+}
+
+void encodeSlot(int64_t slot, ElementType type, char* data) {
+    dispatchElement(type, [slot, data](auto tag) {
+        auto value = fromSlot<typename decltype(tag)::type>(slot);
+        std::memcpy(data, &value, sizeof(value));
+    });
+}
+
+// double выводится без потери точности
+std::string formatSlot(int64_t slot, ElementType type) {
+    return dispatchElement(type, [slot](auto tag) {
+        using T = typename decltype(tag)::type;
+        std::ostringstream out;
+        if constexpr (std::is_floating_point_v<T>) {
+            out.precision(std::numeric_limits<T>::max_digits10);
+        }
+        out << fromSlot<T>(slot);
+        return out.str();
+    });
+}
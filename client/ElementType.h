@@ -0,0 +1,89 @@
+#ifndef ELEMENT_TYPE_H
+#define ELEMENT_TYPE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Тип элементов векторов (и результатов сервера): задаётся параметром -t
+// и одинаков для всего запуска. Разбор, вычисление и запись результатов
+// специализированы для каждого типа на этапе компиляции; передача по сети
+// работает с байтами и шириной элемента.
+//
+// Внутри клиента результат любого типа хранится в 64-битной ячейке
+// (int64_t): int32 — с расширением знака, uint64 и double — побитово.
+// Так контрольные точки, кэш и сборка результатов не зависят от типа.
+// Числовые значения записываются в двоичные файлы (BinaryFormat.h)
+enum class ElementType { Int32 = 0, Int64 = 1, UInt64 = 2, Double = 3 };
+
+const char* elementTypeName(ElementType type);
+// Разбор названия типа: int32, int64, uint64 или double
+bool parseElementType(const std::string& name, ElementType& type);
+size_t elementWidth(ElementType type);
+
+template <class T>
+struct ElementTag {
+    using type = T;
+};
+
+template <class T>
+constexpr ElementType elementTypeOf() {
+    if constexpr (std::is_same_v<T, int32_t>) {
+        return ElementType::Int32;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return ElementType::UInt64;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return ElementType::Double;
+    } else {
+        static_assert(std::is_same_v<T, int64_t>, "unsupported element type");
+        return ElementType::Int64;
+    }
+}
+
+// Вызов action(ElementTag<T>{}) для типа C++, соответствующего type
+template <class Action>
+decltype(auto) dispatchElement(ElementType type, Action&& action) {
+    switch (type) {
+        case ElementType::Int32:
+            return action(ElementTag<int32_t>{});
+        case ElementType::UInt64:
+            return action(ElementTag<uint64_t>{});
+        case ElementType::Double:
+            return action(ElementTag<double>{});
+        default:
+            return action(ElementTag<int64_t>{});
+    }
+}
+
+template <class T>
+int64_t toSlot(T value) {
+    static_assert(sizeof(T) <= sizeof(int64_t), "element wider than a result slot");
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return value;
+    } else {
+        int64_t slot = 0;
+        std::memcpy(&slot, &value, sizeof(value));
+        return slot;
+    }
+}
+
+template <class T>
+T fromSlot(int64_t slot) {
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return static_cast<T>(slot);
+    } else {
+        T value;
+        std::memcpy(&value, &slot, sizeof(value));
+        return value;
+    }
+}
+
+// Ячейка из результата в формате сети (elementWidth(type) байт)
+int64_t decodeSlot(const char* data, ElementType type);
+// Результат в формате сети: elementWidth(type) байт по адресу data
+void encodeSlot(int64_t slot, ElementType type, char* data);
+std::string formatSlot(int64_t slot, ElementType type);
+
+#endif // ELEMENT_TYPE_H
@@ -0,0 +1,318 @@
+#include "EventEngine.h"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+namespace {
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Уровневый epoll: интерес меняется через EPOLL_CTL_MOD только
+// при смене состояния сессии, а не на каждой итерации цикла
+class EpollEngine : public EventEngine {
+    int epollFd;
+    std::vector<epoll_event> ready;
+
+    void control(int op, int fd, unsigned mask) {
+        epoll_event event{};
+        if (mask & POLLIN) {
+            event.events |= EPOLLIN;
+        }
+        if (mask & POLLOUT) {
+            event.events |= EPOLLOUT;
+        }
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, op, fd, &event) == -1) {
+            throw systemError("epoll_ctl failed");
+        }
+    }
+
+public:
+    EpollEngine() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd == -1) {
+            throw systemError("epoll_create1 failed");
+        }
+        control(EPOLL_CTL_ADD, wakeFd, POLLIN);
+    }
+
+    ~EpollEngine() override {
+        close(epollFd);
+    }
+
+protected:
+    void update(int fd, unsigned oldMask, unsigned newMask) override {
+        if (oldMask == 0) {
+            control(EPOLL_CTL_ADD, fd, newMask);
+        } else if (newMask == 0) {
+            control(EPOLL_CTL_DEL, fd, 0);
+        } else {
+            control(EPOLL_CTL_MOD, fd, newMask);
+        }
+    }
+
+    void collect(std::vector<Event>& events, int timeoutMs) override {
+        ready.resize(interests.size() + 1);
+        int count = epoll_wait(epollFd, ready.data(), ready.size(), timeoutMs);
+        if (count == -1) {
+            if (errno == EINTR) {
+                return;
+            }
+            throw systemError("epoll_wait failed");
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = ready[i].data.fd;
+            if (fd == wakeFd) {
+                drainWakeup();
+                continue;
+            }
+            auto it = interests.find(fd);
+            if (it == interests.end()) {
+                continue;
+            }
+            // После разрыва соединения данные ещё можно дочитать,
+            // конец потока сессия увидит сама
+            uint32_t flags = ready[i].events;
+            events.push_back({it->second.context, (flags & (EPOLLIN | EPOLLHUP)) != 0, (flags & EPOLLOUT) != 0,
+                              (flags & EPOLLERR) != 0});
+        }
+    }
+};
+
+#ifdef HAVE_LIBURING
+// io_uring в режиме опроса готовности: на каждый интересующий дескриптор
+// выставлен однократный IORING_OP_POLL_ADD, который после срабатывания
+// заново ставится перед следующим ожиданием. Все запросы итерации уходят
+// в ядро одним io_uring_enter.
+class UringEngine : public EventEngine {
+    struct Armed {
+        uint64_t tag;
+        unsigned mask;
+    };
+
+    io_uring ring;
+    uint64_t nextTag;
+    std::unordered_map<int, Armed> armed;       // Дескриптор -> выставленный запрос
+    std::unordered_map<uint64_t, int> pending;  // Тег запроса -> дескриптор
+
+    io_uring_sqe* acquire() {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+        if (sqe == nullptr) {
+            io_uring_submit(&ring);
+            sqe = io_uring_get_sqe(&ring);
+        }
+        if (sqe == nullptr) {
+            throw std::runtime_error("io_uring submission queue is full");
+        }
+        return sqe;
+    }
+
+    void arm(int fd, unsigned mask) {
+        uint64_t tag = nextTag++;
+        io_uring_sqe* sqe = acquire();
+        io_uring_prep_poll_add(sqe, fd, mask);
+        sqe->user_data = tag;
+        armed[fd] = {tag, mask};
+        pending[tag] = fd;
+    }
+
+    void disarm(int fd) {
+        auto it = armed.find(fd);
+        if (it == armed.end()) {
+            return;
+        }
+        // Запрос отмены сам по себе ничего не сообщает: тег 0
+        io_uring_sqe* sqe = acquire();
+        io_uring_prep_rw(IORING_OP_POLL_REMOVE, sqe, -1, nullptr, 0, 0);
+        sqe->addr = it->second.tag;
+        sqe->user_data = 0;
+        pending.erase(it->second.tag);
+        armed.erase(it);
+    }
+
+public:
+    UringEngine() : nextTag(1) {
+        int ret = io_uring_queue_init(256, &ring, 0);
+        if (ret < 0) {
+            errno = -ret;
+            throw systemError("io_uring_queue_init failed");
+        }
+    }
+
+    ~UringEngine() override {
+        io_uring_queue_exit(&ring);
+    }
+
+protected:
+    void update(int fd, unsigned, unsigned newMask) override {
+        auto it = armed.find(fd);
+        if (it != armed.end() && it->second.mask != newMask) {
+            disarm(fd);
+        }
+    }
+
+    void collect(std::vector<Event>& events, int timeoutMs) override {
+        if (armed.find(wakeFd) == armed.end()) {
+            arm(wakeFd, POLLIN);
+        }
+        for (const auto& entry : interests) {
+            if (entry.second.mask != 0 && armed.find(entry.first) == armed.end()) {
+                arm(entry.first, entry.second.mask);
+            }
+        }
+        io_uring_submit(&ring);
+
+        io_uring_cqe* cqe = nullptr;
+        int ret;
+        if (timeoutMs < 0) {
+            ret = io_uring_wait_cqe(&ring, &cqe);
+        } else {
+            __kernel_timespec timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000000LL};
+            ret = io_uring_wait_cqe_timeout(&ring, &cqe, &timeout);
+        }
+        if (ret == -ETIME || ret == -EINTR) {
+            return;
+        }
+        if (ret < 0) {
+            errno = -ret;
+            throw systemError("io_uring_wait_cqe failed");
+        }
+
+        while (io_uring_peek_cqe(&ring, &cqe) == 0) {
+            uint64_t tag = cqe->user_data;
+            int res = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+
+            auto request = pending.find(tag);
+            if (request == pending.end()) {
+                continue;   // Отмена или отменённый запрос
+            }
+            int fd = request->second;
+            pending.erase(request);
+            armed.erase(fd);
+
+            if (fd == wakeFd) {
+                drainWakeup();
+                continue;
+            }
+            auto it = interests.find(fd);
+            if (it == interests.end() || res == -ECANCELED) {
+                continue;
+            }
+            if (res < 0) {
+                events.push_back({it->second.context, false, false, true});
+            } else {
+                events.push_back({it->second.context, (res & (POLLIN | POLLHUP)) != 0, (res & POLLOUT) != 0,
+                                  (res & POLLERR) != 0});
+            }
+        }
+    }
+};
+#endif
+
+} // namespace
+
+EventEngine::EventEngine() {
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        throw systemError("eventfd failed");
+    }
+}
+
+EventEngine::~EventEngine() {
+    close(wakeFd);
+}
+
+std::unique_ptr<EventEngine> EventEngine::create(Backend backend) {
+    if (backend == Backend::IoUring) {
+#ifdef HAVE_LIBURING
+        return std::make_unique<UringEngine>();
+#else
+        throw std::runtime_error("io_uring support is not compiled in");
+#endif
+    }
+    return std::make_unique<EpollEngine>();
+}
+
+bool EventEngine::isSupported(Backend backend) {
+#ifndef HAVE_LIBURING
+    if (backend == Backend::IoUring) {
+        return false;
+    }
+#endif
+    (void)backend;
+    return true;
+}
+
+const char* EventEngine::backendName(Backend backend) {
+    return backend == Backend::IoUring ? "io_uring" : "epoll";
+}
+
+bool EventEngine::parseBackend(const std::string& name, Backend& backend) {
+    if (name == "epoll") {
+        backend = Backend::Epoll;
+    } else if (name == "io_uring" || name == "uring") {
+        backend = Backend::IoUring;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void EventEngine::watch(int fd, void* context, bool read, bool write) {
+    unsigned mask = (read ? POLLIN : 0) | (write ? POLLOUT : 0);
+    auto it = interests.find(fd);
+    if (it == interests.end()) {
+        if (mask != 0) {
+            update(fd, 0, mask);
+        }
+        interests[fd] = {context, mask};
+        return;
+    }
+    it->second.context = context;
+    if (it->second.mask != mask) {
+        update(fd, it->second.mask, mask);
+        it->second.mask = mask;
+    }
+}
+
+void EventEngine::unwatch(int fd) {
+    auto it = interests.find(fd);
+    if (it == interests.end()) {
+        return;
+    }
+    if (it->second.mask != 0) {
+        update(fd, it->second.mask, 0);
+    }
+    interests.erase(it);
+}
+
+void EventEngine::wait(std::vector<Event>& events, int timeoutMs) {
+    events.clear();
+    collect(events, timeoutMs);
+}
+
+void EventEngine::wakeup() {
+    uint64_t one = 1;
+    // Переполнение счётчика eventfd невозможно на практике, а EAGAIN
+    // означает, что пробуждение и так уже ожидает обработки
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+void EventEngine::drainWakeup() {
+    uint64_t value;
+    ssize_t got = read(wakeFd, &value, sizeof(value));
+    (void)got;
+}
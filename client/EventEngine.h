@@ -0,0 +1,61 @@
+#ifndef EVENT_ENGINE_H
+#define EVENT_ENGINE_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// Ожидание готовности многих сокетов в одном потоке.
+// Реализации: epoll и io_uring (запросы IORING_OP_POLL_ADD), последняя —
+// только при сборке с liburing (HAVE_LIBURING). Интерфейс общий:
+// для каждого дескриптора задаётся интерес к чтению и записи, wait
+// возвращает готовые дескрипторы с их контекстом.
+class EventEngine {
+public:
+    enum class Backend { Epoll, IoUring };
+
+    struct Event {
+        void* context;
+        bool readable;
+        bool writable;
+        bool error;     // Ошибка или разрыв соединения
+    };
+
+    static std::unique_ptr<EventEngine> create(Backend backend);
+    static bool isSupported(Backend backend);
+    static const char* backendName(Backend backend);
+    static bool parseBackend(const std::string& name, Backend& backend);
+
+    virtual ~EventEngine();
+
+    // Регистрация дескриптора или изменение интереса; повторный вызов
+    // с тем же интересом не обращается к ядру
+    void watch(int fd, void* context, bool read, bool write);
+    void unwatch(int fd);
+
+    // Ожидание событий (timeoutMs < 0 — без ограничения). Возвращает и
+    // после wakeup, тогда events может оказаться пустым
+    void wait(std::vector<Event>& events, int timeoutMs = -1);
+
+    // Прерывание wait из другого потока
+    void wakeup();
+
+protected:
+    struct Interest {
+        void* context;
+        unsigned mask;  // POLLIN | POLLOUT
+    };
+
+    int wakeFd;
+    std::unordered_map<int, Interest> interests;
+
+    EventEngine();
+    void drainWakeup();
+
+    virtual void update(int fd, unsigned oldMask, unsigned newMask) = 0;
+    virtual void collect(std::vector<Event>& events, int timeoutMs) = 0;
+};
+
+#endif // EVENT_ENGINE_H
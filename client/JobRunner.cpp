@@ -0,0 +1,809 @@
+#include "JobRunner.h"
+#include "DataReader.h"
+#include "VectorParser.h"
+#include "ChunkedParser.h"
+#include "VectorQueue.h"
+#include "BinaryFormat.h"
+#include "VectorSender.h"
+#include "VectorDedup.h"
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <exception>
+#include <stdexcept>
+#include <sys/resource.h>
+
+namespace {
+
+VectorBatch readInputFile(const std::string& inputFile, unsigned threads, ElementType type) {
+    DataReader reader(inputFile);
+    // Отображённый файл разбирается параллельно по диапазонам строк
+    if (reader.isMapped()) {
+        return ChunkedParser(threads).parse(reader.contents(), type);
+    }
+
+    VectorParser parser;
+    VectorBatch vectors(type);
+    std::string_view line;
+    size_t lineNumber = 0;
+    while (reader.nextLine(line)) {
+        parser.parseVector(line, ++lineNumber, vectors);
+    }
+
+    return vectors;
+}
+
+// Тип элементов двоичного файла записан в его заголовке и должен совпадать с -t
+void checkBinaryType(const BinaryReader& reader, ElementType type) {
+    if (reader.type() != type) {
+        throw std::runtime_error(std::string("Binary file holds ") + elementTypeName(reader.type()) +
+                                 " vectors, not " + elementTypeName(type));
+    }
+}
+
+// Двоичный файл (BinaryFormat.h) загружается без разбора
+VectorBatch readBinaryFile(const std::string& inputFile, ElementType type) {
+    BinaryReader reader(inputFile);
+    checkBinaryType(reader, type);
+    VectorBatch vectors(type);
+    vectors.reserve(reader.count(), 0);
+    while (reader.readNext(vectors)) {
+    }
+    return vectors;
+}
+
+// Процессорное время всех потоков процесса (пользователь и ядро)
+double processCpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+LatencyMonitor::Action slowServerAction(const UserInterface& options) {
+    LatencyMonitor::Action action = LatencyMonitor::Action::Warn;
+    LatencyMonitor::parseAction(options.slowServer, action);
+    return action;
+}
+
+VectorCompute::Operation localOperation(const UserInterface& options) {
+    VectorCompute::Operation operation = VectorCompute::Operation::Sum;
+    VectorCompute::parseOperation(options.operation, operation);
+    return operation;
+}
+
+// Результаты double сервер может получить с другим порядком сложения,
+// поэтому они сравниваются с относительной точностью, остальные — точно
+bool sameResult(int64_t server, int64_t local, ElementType type) {
+    if (type != ElementType::Double) {
+        return server == local;
+    }
+    double a = fromSlot<double>(server);
+    double b = fromSlot<double>(local);
+    return a == b || std::fabs(a - b) <= 1e-9 * std::max(std::fabs(a), std::fabs(b));
+}
+
+// Перемешивание номера вектора (splitmix64): выборка для проверки
+// равномерна и одинакова от запуска к запуску
+uint64_t mixIndex(uint64_t index) {
+    index += 0x9E3779B97F4A7C15ULL;
+    index = (index ^ (index >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    index = (index ^ (index >> 27)) * 0x94D049BB133111EBULL;
+    return index ^ (index >> 31);
+}
+
+} // namespace
+
+VectorBatch loadInputFile(const std::string& inputFile, unsigned threads, ElementType type) {
+    if (BinaryFormat::isBinaryFile(inputFile)) {
+        return readBinaryFile(inputFile, type);
+    }
+    return readInputFile(inputFile, threads, type);
+}
+
+JobRunner::JobRunner(const UserInterface& options, Logger& logger, std::vector<Communicator*> sessions)
+    : options(options), sessions(std::move(sessions)), engine(nullptr), logger(logger),
+      latency(slowServerAction(options), options.slowFactor, options.slowPercentile),
+      compute(localOperation(options), options.elementType), verified(0), cacheBytesSaved(0), duplicatesSkipped(0), dedupBytesSaved(0),
+      dedupLimited(false), wallSeconds(0), cpuSeconds(0) {
+    if (this->sessions.empty()) {
+        throw std::runtime_error("No server connections");
+    }
+    latency.setLogger(&logger);
+}
+
+JobRunner::JobRunner(const UserInterface& options, Logger& logger, std::vector<AsyncSession*> sessions,
+                     EventEngine& engine)
+    : options(options), asyncSessions(std::move(sessions)), engine(&engine), logger(logger),
+      latency(slowServerAction(options), options.slowFactor, options.slowPercentile),
+      compute(localOperation(options), options.elementType), verified(0), cacheBytesSaved(0), duplicatesSkipped(0), dedupBytesSaved(0),
+      dedupLimited(false), wallSeconds(0), cpuSeconds(0) {
+    if (asyncSessions.empty()) {
+        throw std::runtime_error("No server connections");
+    }
+    latency.setLogger(&logger);
+    for (AsyncSession* session : asyncSessions) {
+        session->setMonitor(&latency);
+        session->setElementType(options.elementType);
+    }
+}
+
+size_t JobRunner::connections() const {
+    return engine ? asyncSessions.size() : sessions.size();
+}
+
+std::vector<int64_t> JobRunner::run(const std::string& inputFile, const std::vector<int64_t>& completed,
+                                    Checkpoint* checkpoint, ResultWriter* output) {
+    verified = 0;
+    duplicatesSkipped = 0;
+    dedupBytesSaved = 0;
+    dedupLimited = false;
+    transferStats = Communicator::Stats();
+    openCache();
+    auto wallStart = std::chrono::steady_clock::now();
+    double cpuStart = processCpuSeconds();
+    std::vector<int64_t> results;
+    try {
+        results = options.streamMode ? sendStream(inputFile, completed, checkpoint, output)
+                                     : sendBatch(inputFile, completed, checkpoint, output);
+    } catch (...) {
+        // Записи журнала выводятся раньше сообщения об ошибке
+        logger.flush();
+        throw;
+    }
+    logger.flush();
+    wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    cpuSeconds = processCpuSeconds() - cpuStart;
+    return results;
+}
+
+// Кэш открывается заново в каждом run и остаётся открытым до следующего.
+// Недоступный кэш не мешает обработке файла
+void JobRunner::openCache() {
+    cache.reset();
+    cacheBytesSaved = 0;
+    if (options.cacheFile.empty()) {
+        return;
+    }
+    try {
+        cache = std::make_unique<ResultCache>(options.cacheFile, options.cacheSize);
+    } catch (const std::exception& ex) {
+        logger.warning(std::string(ex.what()) + ", continuing without cache");
+    }
+}
+
+// Счётчики соединений учитывают и аутентификацию; в сводку идёт только
+// то, что передано здесь
+void JobRunner::transfer(std::vector<Shard>& shards) {
+    Communicator::Stats before = sessionStats();
+    if (engine) {
+        transferEvents(shards);
+    } else {
+        transferThreaded(shards);
+    }
+    Communicator::Stats after = sessionStats();
+    transferStats.sendCalls += after.sendCalls - before.sendCalls;
+    transferStats.recvCalls += after.recvCalls - before.recvCalls;
+    transferStats.bytesSent += after.bytesSent - before.bytesSent;
+    transferStats.bytesReceived += after.bytesReceived - before.bytesReceived;
+    transferStats.zeroCopySends += after.zeroCopySends - before.zeroCopySends;
+    transferStats.zeroCopyBytes += after.zeroCopyBytes - before.zeroCopyBytes;
+    transferStats.zeroCopyCopied += after.zeroCopyCopied - before.zeroCopyCopied;
+}
+
+void JobRunner::transferThreaded(std::vector<Shard>& shards) {
+    auto work = [&](size_t k) {
+        Shard& shard = shards[k];
+        VectorSender sender(*sessions[k], options.window, options.zeroCopyThreshold);
+        sender.setMonitor(&latency);
+        sender.setElementType(options.elementType);
+        sender.run(
+            shard.count, [&](VectorView& vec) { return shard.next(vec, true) == AsyncSession::Pull::Vector; },
+            shard.sink);
+    };
+    if (sessions.size() == 1) {
+        work(0);
+        return;
+    }
+
+    // Первая ошибка закрывает все соединения, чтобы остальные потоки не ждали
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+    std::vector<std::thread> workers;
+    workers.reserve(sessions.size());
+    for (size_t k = 0; k < sessions.size(); ++k) {
+        workers.emplace_back([&, k]() {
+            try {
+                work(k);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                    for (Communicator* session : sessions) {
+                        session->shutdown();
+                    }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+// Все сессии обслуживает вызывающий поток: на каждой итерации интерес
+// к сокетам приводится к состоянию автоматов, затем обрабатываются
+// готовые сокеты. Сессии, у которых источник ответил Wait, повторно
+// опрашиваются после пробуждения от очереди векторов
+void JobRunner::transferEvents(std::vector<Shard>& shards) {
+    for (size_t k = 0; k < asyncSessions.size(); ++k) {
+        Shard& shard = shards[k];
+        asyncSessions[k]->assign(
+            shard.count, [&shard](VectorView& vec) { return shard.next(vec, false); }, shard.sink, options.window);
+    }
+
+    driveEvents();
+}
+
+// Ожидание событий ограничено ближайшим сроком сессий: после каждого
+// пробуждения сессии с истёкшим сроком завершают цикл с TimeoutError
+void JobRunner::driveEvents() {
+    using Clock = AsyncSession::Clock;
+    std::vector<EventEngine::Event> events;
+    try {
+        while (true) {
+            bool busy = false;
+            Clock::time_point deadline = Clock::time_point::max();
+            for (AsyncSession* session : asyncSessions) {
+                session->pump();
+                busy = busy || !session->idle();
+                deadline = std::min(deadline, session->deadline());
+                engine->watch(session->fd(), session, session->wantsRead(), session->wantsWrite());
+            }
+            if (!busy) {
+                break;
+            }
+
+            int timeoutMs = -1;
+            if (deadline != Clock::time_point::max()) {
+                auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+                timeoutMs = static_cast<int>(std::max<int64_t>(0, left.count()));
+            }
+            engine->wait(events, timeoutMs);
+            for (const EventEngine::Event& event : events) {
+                static_cast<AsyncSession*>(event.context)->advance(event.readable, event.writable, event.error);
+            }
+            if (deadline != Clock::time_point::max()) {
+                Clock::time_point now = Clock::now();
+                for (AsyncSession* session : asyncSessions) {
+                    session->checkDeadline(now);
+                }
+            }
+        }
+    } catch (...) {
+        // Соединения с незавершённым обменом дальше непригодны
+        for (AsyncSession* session : asyncSessions) {
+            engine->unwatch(session->fd());
+            session->close();
+        }
+        throw;
+    }
+}
+
+void JobRunner::connect() {
+    if (engine) {
+        driveEvents();
+    }
+}
+
+void JobRunner::Plan::set(std::vector<int64_t>& results, size_t index, int64_t result) const {
+    results[index] = result;
+    if (output) {
+        output->set(index, result);
+    }
+}
+
+void JobRunner::Plan::store(std::vector<int64_t>& results, size_t position, int64_t result) const {
+    set(results, vectorAt(position), result);
+    if (!duplicateOffsets.empty()) {
+        for (uint32_t i = duplicateOffsets[position]; i < duplicateOffsets[position + 1]; ++i) {
+            set(results, duplicates[i], result);
+        }
+    }
+}
+
+// Отправляемые векторы раздаются соединениям по кругу: позиция
+// i * N + k плана уходит соединению k. Результаты каждого соединения
+// приходят по порядку, поэтому acked[k] результатов соединения k
+// означают, что готовы все его позиции до acked[k] * N + k
+std::vector<JobRunner::Shard> JobRunner::makeShards(const Plan& plan, std::vector<int64_t>& results,
+                                                    std::vector<std::atomic<uint32_t>>& acked) {
+    size_t parts = acked.size();
+    size_t remaining = plan.count;
+    std::vector<Shard> shards(parts);
+    for (size_t k = 0; k < parts; ++k) {
+        shards[k].count = remaining / parts + (k < remaining % parts ? 1 : 0);
+        shards[k].sink = [&, parts, k](size_t index, int64_t result) {
+            size_t position = index * parts + k;
+            plan.store(results, position, result);
+            acked[k].fetch_add(1, std::memory_order_release);
+            logger.result(plan.vectorAt(position), result);
+        };
+    }
+    return shards;
+}
+
+// Выборочная проверка (--verify): результат выбранного вектора вычисляется
+// локально, когда вектор выдаётся соединению, и сравнивается с ответом
+// сервера до записи. Выборка зависит только от номера вектора, поэтому
+// источник и получатель соединения отбирают одни и те же векторы
+void JobRunner::addVerification(std::vector<Shard>& shards, const Plan& plan,
+                                std::vector<std::unique_ptr<Expected>>& expected) {
+    if (options.verifyRate <= 0) {
+        return;
+    }
+    size_t parts = shards.size();
+    double scaled = options.verifyRate * 18446744073709551616.0;
+    uint64_t limit = scaled >= 18446744073709551615.0 ? UINT64_MAX : static_cast<uint64_t>(scaled);
+    for (size_t k = 0; k < parts; ++k) {
+        expected.push_back(std::make_unique<Expected>());
+        Expected& state = *expected.back();
+        auto next = std::move(shards[k].next);
+        auto sink = std::move(shards[k].sink);
+
+        shards[k].next = [this, next, &state, &plan, parts, k, limit](VectorView& vec, bool wait) {
+            AsyncSession::Pull pull = next(vec, wait);
+            if (pull == AsyncSession::Pull::Vector) {
+                size_t index = plan.vectorAt(static_cast<size_t>(state.pulled++) * parts + k);
+                if (mixIndex(index) <= limit) {
+                    int64_t result = compute.compute(vec);
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.results.push_back(result);
+                }
+            }
+            return pull;
+        };
+        shards[k].sink = [this, sink, &state, &plan, parts, k, limit](size_t i, int64_t result) {
+            size_t index = plan.vectorAt(i * parts + k);
+            if (mixIndex(index) <= limit) {
+                int64_t local;
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    local = state.results.front();
+                    state.results.pop_front();
+                }
+                if (!sameResult(result, local, options.elementType)) {
+                    throw std::runtime_error("Server result " + formatSlot(result, options.elementType) +
+                                             " for vector " + std::to_string(index + 1) + " differs from local " +
+                                             formatSlot(local, options.elementType));
+                }
+                verified.fetch_add(1, std::memory_order_relaxed);
+            }
+            sink(i, result);
+        };
+    }
+}
+
+// Передача с сохранением контрольной точки: раз в checkpointInterval секунд
+// и при ошибке сохраняется непрерывный префикс векторов с результатами
+void JobRunner::transferTracked(std::vector<Shard>& shards, std::vector<int64_t>& results, const Plan& plan,
+                                const std::vector<std::atomic<uint32_t>>& acked, Checkpoint* checkpoint) {
+    if (checkpoint == nullptr) {
+        transfer(shards);
+        return;
+    }
+
+    auto save = [&]() {
+        size_t parts = acked.size();
+        size_t prefix = results.size();
+        for (size_t k = 0; k < parts; ++k) {
+            size_t position = acked[k].load(std::memory_order_acquire) * parts + k;
+            if (position < plan.count) {
+                prefix = std::min(prefix, plan.vectorAt(position));
+            }
+        }
+        checkpoint->update(results.data(), prefix);
+    };
+
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool finished = false;
+    std::thread writer([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto interval = std::chrono::seconds(std::max(1u, options.checkpointInterval));
+        while (!stopped.wait_for(lock, interval, [&] { return finished; })) {
+            lock.unlock();
+            try {
+                save();
+            } catch (const std::exception& ex) {
+                logger.warning(ex.what());
+            }
+            lock.lock();
+        }
+    });
+    auto stopWriter = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        stopped.notify_one();
+        writer.join();
+    };
+
+    try {
+        transfer(shards);
+    } catch (...) {
+        stopWriter();
+        // Ошибка передачи важнее ошибки записи контрольной точки
+        try {
+            save();
+        } catch (const std::exception& ex) {
+            logger.warning(ex.what());
+        }
+        throw;
+    }
+    stopWriter();
+    save();
+}
+
+// Полученные результаты сохраняются в кэше, в том числе после ошибки
+// передачи. keys[k][i] — ключ i-го вектора соединения k
+void JobRunner::storeResults(const std::vector<std::vector<VectorKey>>& keys, const Plan& plan,
+                             const std::vector<int64_t>& results, const std::vector<std::atomic<uint32_t>>& acked) {
+    size_t parts = acked.size();
+    for (size_t k = 0; k < parts; ++k) {
+        size_t count = std::min<size_t>(acked[k].load(std::memory_order_acquire), keys[k].size());
+        for (size_t i = 0; i < count; ++i) {
+            cache->insert(keys[k][i], results[plan.vectorAt(i * parts + k)]);
+        }
+    }
+}
+
+// Обычный режим: файл загружается целиком, векторы с результатами в кэше
+// и повторы уже отправляемых векторов отбрасываются, остальные раздаются
+// соединениям. Результат повтора записывается вместе с результатом
+// первого вхождения, поэтому контрольная точка остаётся верной
+std::vector<int64_t> JobRunner::sendBatch(const std::string& inputFile, const std::vector<int64_t>& completed,
+                                          Checkpoint* checkpoint, ResultWriter* output) {
+    VectorBatch vectors = loadInputFile(inputFile, options.parseThreads, options.elementType);
+    Plan plan;
+    plan.start = completed.size();
+    if (plan.start > vectors.size()) {
+        throw std::runtime_error("Checkpoint has more results than vectors in " + inputFile);
+    }
+
+    std::vector<int64_t> results(vectors.size());
+    if (output) {
+        output->open(vectors.size());
+        plan.output = output;
+    }
+    for (size_t i = 0; i < completed.size(); ++i) {
+        plan.set(results, i, completed[i]);
+    }
+    size_t parts = connections();
+    std::vector<std::vector<VectorKey>> keys(parts);
+    plan.count = vectors.size() - plan.start;
+    std::unique_ptr<VectorDedup> dedup;
+    if (options.dedup) {
+        dedup = std::make_unique<VectorDedup>(plan.count, options.dedupMemory);
+    }
+    if (cache || dedup) {
+        plan.order.reserve(plan.count);
+        for (size_t i = plan.start; i < vectors.size(); ++i) {
+            VectorKey key = hashVector(vectors[i], keySeed());
+            size_t bytes = sizeof(uint32_t) + vectors[i].bytes() + elementWidth(options.elementType);
+            if (dedup && dedup->duplicate(key, i)) {
+                dedupBytesSaved += bytes;
+                continue;
+            }
+            int64_t cached;
+            if (cache && cache->lookup(key, cached)) {
+                plan.set(results, i, cached);
+                cacheBytesSaved += bytes;
+                continue;
+            }
+            if (dedup) {
+                dedup->add(key, plan.order.size());
+            }
+            if (cache) {
+                keys[plan.order.size() % parts].push_back(key);
+            }
+            plan.order.push_back(i);
+        }
+        plan.count = plan.order.size();
+    }
+    if (dedup) {
+        duplicatesSkipped = dedup->duplicates();
+        dedupLimited = dedup->limited();
+        if (duplicatesSkipped > 0) {
+            dedup->collect(plan.count, plan.duplicateOffsets, plan.duplicates);
+        }
+        dedup.reset();
+    }
+
+    std::vector<std::atomic<uint32_t>> acked(parts);
+    std::vector<Shard> shards = makeShards(plan, results, acked);
+    std::vector<size_t> cursors(parts);
+    for (size_t k = 0; k < parts; ++k) {
+        cursors[k] = k;
+        shards[k].next = [&, parts, k](VectorView& vec, bool) {
+            if (cursors[k] >= plan.count) {
+                return AsyncSession::Pull::End;
+            }
+            vec = vectors[plan.vectorAt(cursors[k])];
+            cursors[k] += parts;
+            return AsyncSession::Pull::Vector;
+        };
+    }
+    std::vector<std::unique_ptr<Expected>> expected;
+    addVerification(shards, plan, expected);
+    try {
+        transferTracked(shards, results, plan, acked, checkpoint);
+    } catch (...) {
+        if (cache) {
+            storeResults(keys, plan, results, acked);
+        }
+        throw;
+    }
+    if (cache) {
+        storeResults(keys, plan, results, acked);
+    }
+    return results;
+}
+
+// Потоковый режим: векторы разбираются в отдельном потоке и раздаются
+// соединениям через очереди; объём ожидающих данных во всех очередях
+// ограничен maxMemory. Количество векторов сообщается серверу до разбора,
+// поэтому кэш здесь только пополняется, а канал или сжатый файл при
+// подсчёте копируется во временный файл (DataReader::openCounted)
+std::vector<int64_t> JobRunner::sendStream(const std::string& inputFile, const std::vector<int64_t>& completed,
+                                           Checkpoint* checkpoint, ResultWriter* output) {
+    // Количество векторов передаётся серверу до самих векторов
+    bool binary = BinaryFormat::isBinaryFile(inputFile);
+    std::unique_ptr<BinaryReader> binaryReader;
+    std::unique_ptr<DataReader> textReader;
+    uint32_t numVectors;
+    if (binary) {
+        binaryReader = std::make_unique<BinaryReader>(inputFile);
+        checkBinaryType(*binaryReader, options.elementType);
+        numVectors = binaryReader->count();
+    } else {
+        size_t lines = 0;
+        textReader = DataReader::openCounted(inputFile, lines);
+        if (lines > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Too many vectors in " + inputFile);
+        }
+        numVectors = static_cast<uint32_t>(lines);
+    }
+    size_t start = completed.size();
+    if (start > numVectors) {
+        throw std::runtime_error("Checkpoint has more results than vectors in " + inputFile);
+    }
+    Plan plan;
+    plan.start = start;
+    plan.count = numVectors - start;
+    if (output) {
+        output->open(numVectors);
+        plan.output = output;
+    }
+
+    // Векторы передаются через очереди пачками, чтобы не платить за
+    // синхронизацию на каждой строке; пачка занимает не больше четверти бюджета очереди
+    size_t parts = connections();
+    size_t budget = std::max<size_t>(1, options.maxMemory / parts);
+    ElementType type = options.elementType;
+    size_t chunkValues = std::max<size_t>(1, std::min<size_t>(budget / 4, 1 << 20) / elementWidth(type));
+    std::vector<std::unique_ptr<VectorQueue>> queues;
+    for (size_t k = 0; k < parts; ++k) {
+        queues.push_back(std::make_unique<VectorQueue>(budget));
+        if (engine) {
+            queues.back()->setListener([this]() { engine->wakeup(); });
+        }
+    }
+
+    std::thread producer([&]() {
+        try {
+            VectorParser parser;
+            std::vector<VectorBatch> chunks(parts, VectorBatch(type));
+            std::string_view line;
+            size_t lineNumber = 0;
+
+            // Векторы с сохранёнными результатами пропускаются без разбора
+            VectorBatch skipped(type);
+            for (size_t i = 0; i < start; ++i) {
+                bool present = binary ? binaryReader->readNext(skipped) : textReader->nextLine(line);
+                if (!present) {
+                    break;
+                }
+                ++lineNumber;
+                skipped.clear();
+            }
+
+            for (size_t i = 0;; ++i) {
+                VectorBatch& chunk = chunks[i % parts];
+                if (binary) {
+                    if (!binaryReader->readNext(chunk)) {
+                        break;
+                    }
+                } else {
+                    if (!textReader->nextLine(line)) {
+                        break;
+                    }
+                    parser.parseVector(line, ++lineNumber, chunk);
+                }
+                if (chunk.totalValues() >= chunkValues) {
+                    if (!queues[i % parts]->push(std::move(chunk))) {
+                        return;
+                    }
+                    chunk = VectorBatch(type);
+                }
+            }
+            for (size_t k = 0; k < parts; ++k) {
+                if (!chunks[k].empty()) {
+                    queues[k]->push(std::move(chunks[k]));
+                }
+                queues[k]->close();
+            }
+        } catch (...) {
+            for (auto& queue : queues) {
+                queue->fail(std::current_exception());
+            }
+        }
+    });
+
+    std::vector<int64_t> results(numVectors);
+    for (size_t i = 0; i < completed.size(); ++i) {
+        plan.set(results, i, completed[i]);
+    }
+    std::vector<std::atomic<uint32_t>> acked(parts);
+    std::vector<Shard> shards = makeShards(plan, results, acked);
+    // Текущая пачка соединения живёт, пока из неё отправляются векторы
+    std::vector<VectorBatch> current(parts);
+    std::vector<size_t> cursors(parts, 0);
+    std::vector<std::vector<VectorKey>> keys(parts);
+    for (size_t k = 0; k < parts; ++k) {
+        shards[k].next = [&, k](VectorView& vec, bool wait) {
+            while (cursors[k] == current[k].size()) {
+                if (wait) {
+                    if (!queues[k]->pop(current[k])) {
+                        return AsyncSession::Pull::End;
+                    }
+                } else {
+                    bool finished = false;
+                    if (!queues[k]->tryPop(current[k], finished)) {
+                        return finished ? AsyncSession::Pull::End : AsyncSession::Pull::Wait;
+                    }
+                }
+                cursors[k] = 0;
+            }
+            vec = current[k][cursors[k]++];
+            if (cache) {
+                keys[k].push_back(hashVector(vec, keySeed()));
+            }
+            return AsyncSession::Pull::Vector;
+        };
+    }
+    std::vector<std::unique_ptr<Expected>> expected;
+    addVerification(shards, plan, expected);
+
+    try {
+        transferTracked(shards, results, plan, acked, checkpoint);
+    } catch (...) {
+        for (auto& queue : queues) {
+            queue->close();
+        }
+        producer.join();
+        if (cache) {
+            storeResults(keys, plan, results, acked);
+        }
+        throw;
+    }
+    producer.join();
+    if (cache) {
+        storeResults(keys, plan, results, acked);
+    }
+
+    size_t received = 0;
+    for (const auto& count : acked) {
+        received += count;
+    }
+    if (received != numVectors - start) {
+        throw std::runtime_error("Input file changed while streaming: " + inputFile);
+    }
+    return results;
+}
+
+Communicator::Stats JobRunner::sessionStats() const {
+    std::vector<const Communicator::Stats*> all;
+    for (const Communicator* session : sessions) {
+        all.push_back(&session->stats());
+    }
+    for (const AsyncSession* session : asyncSessions) {
+        all.push_back(&session->stats());
+    }
+
+    Communicator::Stats total;
+    for (const Communicator::Stats* stats : all) {
+        total.sendCalls += stats->sendCalls;
+        total.recvCalls += stats->recvCalls;
+        total.bytesSent += stats->bytesSent;
+        total.bytesReceived += stats->bytesReceived;
+        total.zeroCopySends += stats->zeroCopySends;
+        total.zeroCopyBytes += stats->zeroCopyBytes;
+        total.zeroCopyCopied += stats->zeroCopyCopied;
+    }
+    return total;
+}
+
+void JobRunner::printStats(size_t vectors) {
+    const Communicator::Stats& total = transferStats;
+
+    // Строки сводки выводятся через журнал (уровень info)
+    std::ostringstream line;
+    auto emit = [&]() {
+        logger.info(line.str());
+        line.str("");
+    };
+
+    // Векторы, найденные в кэше, и повторы не отправлялись
+    size_t sent = vectors - std::min<size_t>(vectors, (cache ? cache->stats().hits : 0) + duplicatesSkipped);
+    line << "Sent " << sent << " vectors over " << connections() << " connection(s): "
+         << total.sendCalls << " send calls";
+    if (sent > 0) {
+        line << " (" << static_cast<double>(total.sendCalls) / sent << " per vector)";
+    }
+    line << ", " << total.recvCalls << " receive calls, " << total.bytesSent << " bytes sent";
+    emit();
+    // Время последнего run: для сравнения транспортов (TCP и сокет Unix)
+    line << "Time: " << wallSeconds * 1e3 << " ms wall, " << cpuSeconds * 1e3 << " ms CPU";
+    if (vectors > 0) {
+        line << " (" << wallSeconds * 1e6 / vectors << " us wall, " << cpuSeconds * 1e6 / vectors
+             << " us CPU per vector)";
+    }
+    emit();
+    if (total.zeroCopySends > 0) {
+        line << "Zero-copy: " << total.zeroCopyBytes << " bytes in " << total.zeroCopySends << " sends, "
+             << total.zeroCopyCopied << " completions fell back to copying";
+        emit();
+    }
+    if (options.verifyRate > 0) {
+        line << "Verified " << verified << " results locally (" << VectorCompute::operationName(compute.operation())
+             << ", " << VectorCompute::kernelName(compute.kernel()) << "): all match";
+        emit();
+    }
+    if (options.dedup && !options.streamMode) {
+        line << "Dedup: " << duplicatesSkipped << " repeated vectors not sent";
+        if (vectors > 0) {
+            line << " (" << 100.0 * duplicatesSkipped / vectors << "%)";
+        }
+        line << ", " << dedupBytesSaved << " bytes saved";
+        if (dedupLimited) {
+            line << ", memory limit reached (increase --dedup-memory)";
+        }
+        emit();
+    }
+    if (cache) {
+        const ResultCache::Stats& stats = cache->stats();
+        line << "Cache: " << stats.hits << " of " << stats.lookups << " vectors found";
+        if (stats.lookups > 0) {
+            line << " (" << 100.0 * stats.hits / stats.lookups << "%)";
+        }
+        line << ", " << cacheBytesSaved << " bytes not sent, " << cache->entries() << " of "
+             << cache->capacity() << " entries used, " << stats.evictions << " evicted";
+        emit();
+    }
+    std::string latencySummary = latency.summary();
+    if (!latencySummary.empty()) {
+        line << "Latency: " << latencySummary;
+        emit();
+    }
+    logger.flush();
+}
@@ -0,0 +1,134 @@
+#ifndef JOB_RUNNER_H
+#define JOB_RUNNER_H
+
+#include "UserInterface.h"
+#include "Communicator.h"
+#include "AsyncSession.h"
+#include "EventEngine.h"
+#include "VectorBatch.h"
+#include "Checkpoint.h"
+#include "LatencyMonitor.h"
+#include "VectorCompute.h"
+#include "VectorHash.h"
+#include "ResultCache.h"
+#include "ResultWriter.h"
+#include "Logger.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <deque>
+#include <memory>
+#include <cstdint>
+
+// Обработка одного входного файла на наборе аутентифицированных соединений.
+// Векторы раздаются соединениям по кругу, результаты собираются в
+// порядке входного файла. Соединения обслуживаются либо каждое своим
+// потоком (Communicator), либо все одним циклом событий (AsyncSession).
+class JobRunner {
+public:
+    // logger получает результаты (уровень debug), предупреждения и сводку
+    JobRunner(const UserInterface& options, Logger& logger, std::vector<Communicator*> sessions);
+    // Сессии должны быть запущены (AsyncSession::start); аутентификация
+    // завершается в том же цикле событий, что и передача векторов
+    JobRunner(const UserInterface& options, Logger& logger, std::vector<AsyncSession*> sessions,
+              EventEngine& engine);
+
+    // Завершение подключения и аутентификации сессий цикла событий
+    // (для потоков соединения уже аутентифицированы)
+    void connect();
+
+    // Отправка векторов файла; результаты — по порядку векторов.
+    // completed — уже известные результаты первых векторов (продолжение
+    // по контрольной точке), эти векторы не отправляются. Если задан
+    // checkpoint, ход выполнения периодически сохраняется в него.
+    // Если задан output, он открывается на число векторов файла и получает
+    // каждый результат по мере прихода; finish вызывает владелец
+    std::vector<int64_t> run(const std::string& inputFile, const std::vector<int64_t>& completed = {},
+                             Checkpoint* checkpoint = nullptr, ResultWriter* output = nullptr);
+
+    // Сводка по сетевому обмену и времени ответа всех соединений
+    void printStats(size_t vectors);
+
+private:
+    // Часть задания для одного соединения. next с wait = false не
+    // блокируется и возвращает Wait, если вектор ещё не прочитан
+    struct Shard {
+        uint32_t count = 0;
+        std::function<AsyncSession::Pull(VectorView& vec, bool wait)> next;
+        std::function<void(size_t index, int64_t result)> sink;
+    };
+
+    // Порядок отправки: p-й отправляемый вектор — это вектор start + p
+    // входного файла, а если часть векторов не отправляется (результат
+    // найден в кэше или вектор повторяется) — вектор order[p]
+    struct Plan {
+        size_t start = 0;
+        size_t count = 0;       // Векторов к отправке
+        std::vector<size_t> order;
+        // Повторы, получающие результат позиции p (VectorDedup::collect)
+        std::vector<uint32_t> duplicateOffsets;
+        std::vector<uint32_t> duplicates;
+        ResultWriter* output = nullptr;
+
+        size_t vectorAt(size_t position) const { return order.empty() ? start + position : order[position]; }
+        // Запись результата вектора index (и в output, если он задан)
+        void set(std::vector<int64_t>& results, size_t index, int64_t result) const;
+        // Запись результата позиции в её вектор и все его повторы
+        void store(std::vector<int64_t>& results, size_t position, int64_t result) const;
+    };
+
+    // Локально вычисленные результаты проверяемых векторов одного
+    // соединения в порядке отправки (--verify)
+    struct Expected {
+        std::mutex mutex;
+        std::deque<int64_t> results;
+        uint32_t pulled = 0;    // Векторов выдано соединению
+    };
+
+    const UserInterface& options;
+    std::vector<Communicator*> sessions;
+    std::vector<AsyncSession*> asyncSessions;
+    EventEngine* engine;
+    Logger& logger;
+    LatencyMonitor latency;     // Время ответа сервера по всем соединениям
+    VectorCompute compute;      // Локальное вычисление для проверки результатов
+    std::atomic<uint64_t> verified;
+    std::unique_ptr<ResultCache> cache;     // Кэш результатов последнего run (--cache)
+    uint64_t cacheBytesSaved;   // Байт векторов и результатов, не переданных благодаря кэшу
+    uint64_t duplicatesSkipped; // Повторы векторов, не отправленные в последнем run (--dedup)
+    uint64_t dedupBytesSaved;
+    bool dedupLimited;          // Памяти --dedup-memory не хватило на весь файл
+    Communicator::Stats transferStats;  // Обмен векторами и результатами в последнем run (без аутентификации)
+    double wallSeconds;     // Длительность последнего run
+    double cpuSeconds;      // Процессорное время процесса за последний run
+
+    size_t connections() const;
+    Communicator::Stats sessionStats() const;   // Сумма счётчиков всех соединений
+    std::vector<int64_t> sendBatch(const std::string& inputFile, const std::vector<int64_t>& completed,
+                                   Checkpoint* checkpoint, ResultWriter* output);
+    std::vector<int64_t> sendStream(const std::string& inputFile, const std::vector<int64_t>& completed,
+                                    Checkpoint* checkpoint, ResultWriter* output);
+    void openCache();
+    // Векторы с одинаковыми байтами, но разного типа получают разные ключи кэша
+    uint64_t keySeed() const { return static_cast<uint64_t>(options.elementType); }
+    std::vector<Shard> makeShards(const Plan& plan, std::vector<int64_t>& results,
+                                  std::vector<std::atomic<uint32_t>>& acked);
+    void addVerification(std::vector<Shard>& shards, const Plan& plan,
+                         std::vector<std::unique_ptr<Expected>>& expected);
+    void transferTracked(std::vector<Shard>& shards, std::vector<int64_t>& results, const Plan& plan,
+                         const std::vector<std::atomic<uint32_t>>& acked, Checkpoint* checkpoint);
+    void storeResults(const std::vector<std::vector<VectorKey>>& keys, const Plan& plan,
+                      const std::vector<int64_t>& results, const std::vector<std::atomic<uint32_t>>& acked);
+    void transfer(std::vector<Shard>& shards);
+    void transferThreaded(std::vector<Shard>& shards);
+    void transferEvents(std::vector<Shard>& shards);
+    void driveEvents();
+};
+
+// Загрузка входного файла целиком: текстового (с разбором в threads потоков)
+// или двоичного (BinaryFormat.h) с элементами типа type
+VectorBatch loadInputFile(const std::string& inputFile, unsigned threads, ElementType type);
+
+#endif // JOB_RUNNER_H
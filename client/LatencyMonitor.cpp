@@ -0,0 +1,97 @@
+#include "LatencyMonitor.h"
+#include "Logger.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+namespace {
+// Размер окна последних ответов
+const size_t windowSize = 1024;
+// Порог пересчитывается раз в столько ответов
+const uint64_t recomputePeriod = 128;
+// До стольких ответов порог не вычисляется: первые ответы включают разогрев
+const uint64_t warmupSamples = 128;
+// Ответы быстрее этого не считаются медленными: задержки такого
+// порядка дают планировщик и загрузка машины, а не сервер
+const double minimumThresholdMs = 10.0;
+// Не чаще одного предупреждения за это время
+const auto warningInterval = std::chrono::seconds(1);
+}
+
+LatencyMonitor::LatencyMonitor(Action action, double factor, double percentile)
+    : action(action), factor(factor), percentile(percentile), next(0), total(0), slow(0), maxLatency(0),
+      threshold(0), logger(nullptr) {
+    samples.reserve(windowSize);
+}
+
+bool LatencyMonitor::parseAction(const std::string& name, Action& action) {
+    if (name == "off") {
+        action = Action::Off;
+    } else if (name == "warn") {
+        action = Action::Warn;
+    } else if (name == "abort") {
+        action = Action::Abort;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+double LatencyMonitor::quantile(std::vector<double>& values, double p) const {
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p / 100 * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void LatencyMonitor::record(double milliseconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (samples.size() < windowSize) {
+        samples.push_back(milliseconds);
+    } else {
+        samples[next] = milliseconds;
+        next = (next + 1) % windowSize;
+    }
+    ++total;
+    maxLatency = std::max(maxLatency, milliseconds);
+
+    if (total >= warmupSamples && total % recomputePeriod == 0) {
+        std::vector<double> window(samples);
+        threshold = std::max(minimumThresholdMs, factor * quantile(window, percentile));
+    }
+    if (threshold == 0 || milliseconds <= threshold) {
+        return;
+    }
+
+    ++slow;
+    if (action == Action::Off) {
+        return;
+    }
+    std::ostringstream message;
+    message << "Slow server response: " << milliseconds << " ms, limit " << threshold << " ms (" << factor
+            << " x p" << percentile << ")";
+    if (action == Action::Abort) {
+        throw SlowServerError(message.str());
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastWarning >= warningInterval) {
+        lastWarning = now;
+        if (logger) {
+            logger->warning(message.str());
+        } else {
+            std::cerr << "Warning: " << message.str() << std::endl;
+        }
+    }
+}
+
+std::string LatencyMonitor::summary() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (samples.empty()) {
+        return "";
+    }
+    std::vector<double> window(samples);
+    std::ostringstream text;
+    text << "p50 " << quantile(window, 50) << " ms, p" << percentile << " " << quantile(window, percentile)
+         << " ms over the last " << samples.size() << " responses, max " << maxLatency << " ms, " << slow
+         << " slow";
+    return text.str();
+}
@@ -0,0 +1,61 @@
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+class Logger;
+
+// Ответ сервера медленнее допустимого (режим Abort)
+class SlowServerError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Скользящая статистика времени ответа сервера на вектор (от отправки
+// до результата). Ответ считается медленным, если он дольше factor
+// процентиля percentile последних ответов; в зависимости от режима
+// медленный ответ только считается, выводится предупреждение или
+// передача прерывается. Методы можно вызывать из нескольких потоков.
+class LatencyMonitor {
+public:
+    enum class Action { Off, Warn, Abort };
+
+    LatencyMonitor(Action action, double factor, double percentile);
+
+    // Разбор режима: off, warn или abort
+    static bool parseAction(const std::string& name, Action& action);
+
+    // Учёт одного ответа; в режиме Abort медленный ответ — SlowServerError
+    void record(double milliseconds);
+
+    // Предупреждения о медленных ответах выводятся в журнал (nullptr — в stderr)
+    void setLogger(Logger* logger) { this->logger = logger; }
+
+    // Сводка по последним ответам ("" — ответов не было)
+    std::string summary() const;
+
+private:
+    Action action;
+    double factor;
+    double percentile;
+
+    mutable std::mutex mutex;
+    std::vector<double> samples;    // Кольцевое окно последних ответов
+    size_t next;
+    uint64_t total;
+    uint64_t slow;
+    double maxLatency;
+    double threshold;               // Порог медленного ответа (0 — ещё не вычислен)
+    std::chrono::steady_clock::time_point lastWarning;
+    Logger* logger;
+
+    double quantile(std::vector<double>& values, double p) const;
+};
+
+#endif // LATENCY_MONITOR_H
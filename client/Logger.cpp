@@ -0,0 +1,238 @@
+#include "Logger.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Записей в очереди
+const size_t queueCapacity = 8192;
+// Накопленный вывод записывается в поток, как только его становится больше
+const size_t outputChunk = 64 * 1024;
+
+const char* levelName(Logger::Level level) {
+    switch (level) {
+        case Logger::Level::Error:
+            return "error";
+        case Logger::Level::Warning:
+            return "warn";
+        case Logger::Level::Info:
+            return "info";
+        default:
+            return "debug";
+    }
+}
+
+void appendJsonString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+bool Logger::parseLevel(const std::string& name, Level& level) {
+    for (Level candidate : {Level::Error, Level::Warning, Level::Info, Level::Debug}) {
+        if (name == levelName(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Logger::parseFormat(const std::string& name, Format& format) {
+    if (name == "text") {
+        format = Format::Text;
+    } else if (name == "json") {
+        format = Format::Json;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Logger::Logger(Level level, Format format, ElementType type)
+    : threshold(level), outputFormat(format), elementType(type), start(std::chrono::steady_clock::now()),
+      cells(queueCapacity), mask(queueCapacity - 1), tail(0), head(0), written(0), sleeping(false),
+      stopping(false) {
+    for (size_t i = 0; i < cells.size(); ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker = std::thread([this]() { run(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void Logger::message(Level level, std::string text) {
+    if (enabled(level)) {
+        push({Kind::Message, level, secondsSinceStart(), 0, 0, std::move(text)});
+    }
+}
+
+void Logger::push(Record&& record) {
+    while (!tryPush(record)) {
+        std::this_thread::yield();
+    }
+    // Пара барьеров с run: либо потребитель увидит запись, либо мы — его сон
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake.notify_one();
+    }
+}
+
+// Ограниченная очередь Вьюкова: позиция занимается сравнением с обменом,
+// запись публикуется номером последовательности ячейки
+bool Logger::tryPush(Record& record) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[position & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - position);
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = std::move(record);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::tryPop(Record& record) {
+    Cell& cell = cells[head & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+        return false;
+    }
+    record = std::move(cell.record);
+    cell.sequence.store(head + cells.size(), std::memory_order_release);
+    ++head;
+    return true;
+}
+
+bool Logger::empty() const {
+    return cells[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+}
+
+void Logger::flush() {
+    size_t target = tail.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.notify_one();
+    drained.wait(lock, [&] { return written.load(std::memory_order_acquire) >= target; });
+}
+
+void Logger::run() {
+    std::string out;
+    std::string errors;
+    Record record;
+    while (true) {
+        while (tryPop(record)) {
+            formatRecord(record, out, errors);
+            // Предупреждения выводятся сразу, после предшествующих записей
+            if (!errors.empty()) {
+                std::cout.write(out.data(), out.size()).flush();
+                std::cerr.write(errors.data(), errors.size()).flush();
+                out.clear();
+                errors.clear();
+            } else if (out.size() >= outputChunk) {
+                std::cout.write(out.data(), out.size());
+                out.clear();
+            }
+        }
+        if (!out.empty()) {
+            std::cout.write(out.data(), out.size());
+            out.clear();
+        }
+        std::cout.flush();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        written.store(head, std::memory_order_release);
+        drained.notify_all();
+        if (stopping && empty()) {
+            return;
+        }
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (empty()) {
+            wake.wait_for(lock, std::chrono::milliseconds(100), [&] { return stopping || !empty(); });
+        }
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::formatRecord(const Record& record, std::string& out, std::string& errors) const {
+    if (outputFormat == Format::Text) {
+        if (record.kind == Kind::Result) {
+            out += "Received result: ";
+            out += formatSlot(record.value, elementType);
+            out += '\n';
+        } else if (record.level <= Level::Warning) {
+            errors += record.level == Level::Error ? "Error: " : "Warning: ";
+            errors += record.text;
+            errors += '\n';
+        } else {
+            out += record.text;
+            out += '\n';
+        }
+        return;
+    }
+
+    char time[32];
+    std::snprintf(time, sizeof(time), "%.6f", record.time);
+    out += "{\"time\":";
+    out += time;
+    out += ",\"level\":\"";
+    out += levelName(record.level);
+    if (record.kind == Kind::Result) {
+        out += "\",\"event\":\"result\",\"vector\":";
+        out += std::to_string(record.index + 1);
+        out += ",\"value\":";
+        // Бесконечность и NaN не являются числами JSON
+        if (elementType == ElementType::Double && !std::isfinite(fromSlot<double>(record.value))) {
+            appendJsonString(out, formatSlot(record.value, elementType));
+        } else {
+            out += formatSlot(record.value, elementType);
+        }
+    } else {
+        out += "\",\"message\":";
+        appendJsonString(out, record.text);
+    }
+    out += "}\n";
+}
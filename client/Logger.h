@@ -0,0 +1,109 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "ElementType.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// Журнал клиента. Записи создаются в рабочих потоках без форматирования и
+// блокировок и попадают в ограниченную кольцевую очередь (несколько
+// производителей, один потребитель); форматирует и выводит их фоновый
+// поток, сбрасывая вывод, только когда очередь опустела. Уровень отсекает
+// записи до очереди: проверка enabled — одно сравнение, поэтому отключённый
+// вывод результатов почти ничего не стоит. Если очередь заполнена,
+// производитель ждёт — записи не теряются.
+//
+// Формат text: ошибки и предупреждения — в stderr с префиксом, остальное —
+// в stdout. Формат json: каждая запись — объект JSON в отдельной строке
+// stdout (JSON Lines) с полями time (секунды от создания журнала), level
+// и message либо, для результатов, event, vector (номер с единицы) и value.
+class Logger {
+public:
+    enum class Level { Error, Warning, Info, Debug };
+    enum class Format { Text, Json };
+
+    // Разбор уровня (error, warn, info или debug) и формата (text или json)
+    static bool parseLevel(const std::string& name, Level& level);
+    static bool parseFormat(const std::string& name, Format& format);
+
+    // type — тип результатов (ElementType.h)
+    Logger(Level level, Format format, ElementType type = ElementType::Int64);
+    // Выводит оставшиеся записи
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    bool enabled(Level level) const { return level <= threshold; }
+
+    void message(Level level, std::string text);
+    void error(std::string text) { message(Level::Error, std::move(text)); }
+    void warning(std::string text) { message(Level::Warning, std::move(text)); }
+    void info(std::string text) { message(Level::Info, std::move(text)); }
+
+    // Результат вектора index (с нуля) в ячейке; уровень Debug
+    void result(size_t index, int64_t slot) {
+        if (enabled(Level::Debug)) {
+            push({Kind::Result, Level::Debug, secondsSinceStart(), index, slot, {}});
+        }
+    }
+
+    // Ожидание вывода всех записей, поставленных до вызова
+    void flush();
+
+private:
+    enum class Kind { Message, Result };
+
+    struct Record {
+        Kind kind;
+        Level level;
+        double time;
+        uint64_t index;
+        int64_t value;
+        std::string text;
+    };
+
+    // Ячейка очереди: sequence == позиция — свободна для записи,
+    // позиция + 1 — заполнена и ждёт потребителя
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    Level threshold;
+    Format outputFormat;
+    ElementType elementType;
+    std::chrono::steady_clock::time_point start;
+
+    std::vector<Cell> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail;   // Следующая позиция записи
+    alignas(64) size_t head;                // Следующая позиция чтения (только фоновый поток)
+    std::atomic<size_t> written;            // Позиций выведено и сброшено
+    std::atomic<bool> sleeping;
+    bool stopping;
+
+    std::mutex mutex;                       // Только для ожидания: сон потребителя и flush
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::thread worker;
+
+    double secondsSinceStart() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    void push(Record&& record);
+    bool tryPush(Record& record);
+    bool tryPop(Record& record);
+    bool empty() const;
+    void run();
+    void formatRecord(const Record& record, std::string& out, std::string& errors) const;
+};
+
+#endif // LOGGER_H
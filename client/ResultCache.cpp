@@ -0,0 +1,244 @@
+#include "ResultCache.h"
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct ResultCache::Header {
+    char magic[4];
+    uint32_t generation;    // Номер последнего запуска, открывавшего кэш
+    uint64_t slots;
+    uint64_t entries;
+    char reserved[40];
+};
+
+struct ResultCache::Slot {
+    uint64_t keyLow;
+    uint64_t keyHigh;
+    int64_t result;
+    uint32_t generation;    // Запуск, в котором запись использовалась последней
+    uint32_t check;         // 0 — пустая ячейка
+};
+
+namespace {
+
+const char cacheMagic[4] = {'V', 'R', 'C', '1'};
+// Ячеек в группе: группа занимает четыре строки кэша процессора
+const size_t ways = 8;
+const size_t minGroups = 8;
+
+uint32_t checksum(uint64_t keyLow, uint64_t keyHigh, int64_t result) {
+    uint64_t h = keyLow ^ (keyHigh * 0x9E3779B185EBCA87ULL) ^ (static_cast<uint64_t>(result) * 0xC2B2AE3D27D4EB4FULL);
+    h ^= h >> 29;
+    h *= 0x165667B19E3779F9ULL;
+    return static_cast<uint32_t>(h >> 32) | 1;
+}
+
+// Число ячеек (целое число групп), умещающееся в maxBytes
+size_t slotsFor(size_t maxBytes, size_t headerBytes, size_t slotBytes) {
+    size_t fit = maxBytes > headerBytes ? (maxBytes - headerBytes) / slotBytes : 0;
+    return std::max(fit / ways, minGroups) * ways;
+}
+
+} // namespace
+
+ResultCache::ResultCache(const std::string& path, size_t maxBytes)
+    : path(path), fd(-1), mapping(nullptr), header(nullptr), slots(nullptr), slotCount(0), generation(0) {
+    static_assert(sizeof(Header) == 64, "cache header must be 64 bytes");
+    static_assert(sizeof(Slot) == 32, "cache slot must be 32 bytes");
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open result cache " + path + ": " + std::strerror(errno));
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) == -1) {
+        ::close(fd);
+        throw std::runtime_error("Result cache " + path + " is in use by another process");
+    }
+
+    try {
+        size_t wanted = slotsFor(maxBytes, sizeof(Header), sizeof(Slot));
+        struct stat info;
+        fstat(fd, &info);
+        if (info.st_size == 0) {
+            initialize(wanted);
+        } else {
+            Header existing;
+            if (info.st_size < static_cast<off_t>(sizeof(Header)) ||
+                pread(fd, &existing, sizeof(existing), 0) != static_cast<ssize_t>(sizeof(existing)) ||
+                std::memcmp(existing.magic, cacheMagic, sizeof(cacheMagic)) != 0) {
+                throw std::runtime_error(path + " is not a result cache");
+            }
+            bool consistent = existing.slots >= minGroups * ways && existing.slots % ways == 0 &&
+                              static_cast<uint64_t>(info.st_size) == sizeof(Header) + existing.slots * sizeof(Slot);
+            // Повреждённый кэш просто создаётся заново
+            if (!consistent) {
+                initialize(wanted);
+            } else {
+                map(existing.slots);
+                if (slotCount != wanted) {
+                    resize(wanted);
+                }
+            }
+        }
+    } catch (...) {
+        unmap();
+        ::close(fd);
+        throw;
+    }
+
+    generation = header->generation + 1;
+    if (generation == 0) {
+        generation = 1;
+    }
+    header->generation = generation;
+}
+
+ResultCache::~ResultCache() {
+    unmap();
+    ::close(fd);
+}
+
+void ResultCache::map(size_t count) {
+    size_t bytes = sizeof(Header) + count * sizeof(Slot);
+    void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error("Failed to map result cache " + path + ": " + std::strerror(errno));
+    }
+    mapping = static_cast<char*>(region);
+    header = reinterpret_cast<Header*>(mapping);
+    slots = reinterpret_cast<Slot*>(mapping + sizeof(Header));
+    slotCount = count;
+}
+
+void ResultCache::unmap() {
+    if (mapping != nullptr) {
+        munmap(mapping, fileBytes());
+        mapping = nullptr;
+        header = nullptr;
+        slots = nullptr;
+    }
+}
+
+void ResultCache::initialize(size_t count) {
+    unmap();
+    if (ftruncate(fd, 0) == -1 || ftruncate(fd, sizeof(Header) + count * sizeof(Slot)) == -1) {
+        throw std::runtime_error("Failed to create result cache " + path + ": " + std::strerror(errno));
+    }
+    map(count);
+    std::memcpy(header->magic, cacheMagic, sizeof(cacheMagic));
+    header->generation = 0;
+    header->slots = count;
+    header->entries = 0;
+}
+
+// Перенос записей в таблицу другого размера: более новые вставляются
+// последними и при нехватке места вытесняют старые
+void ResultCache::resize(size_t count) {
+    std::vector<Slot> live;
+    for (size_t i = 0; i < slotCount; ++i) {
+        const Slot& slot = slots[i];
+        if (slot.check != 0 && slot.check == checksum(slot.keyLow, slot.keyHigh, slot.result)) {
+            live.push_back(slot);
+        }
+    }
+    std::stable_sort(live.begin(), live.end(),
+                     [](const Slot& a, const Slot& b) { return a.generation < b.generation; });
+
+    uint32_t lastGeneration = header->generation;
+    initialize(count);
+    header->generation = lastGeneration;
+    for (const Slot& slot : live) {
+        generation = slot.generation;
+        insert({slot.keyLow, slot.keyHigh}, slot.result);
+    }
+    counters = Stats();
+}
+
+// Отображение 64-битного хэша на номер группы умножением, без деления
+ResultCache::Slot* ResultCache::group(uint64_t hash) const {
+    uint64_t groups = slotCount / ways;
+    return slots + static_cast<size_t>((static_cast<unsigned __int128>(hash) * groups) >> 64) * ways;
+}
+
+// Ячейка с ключом key в одной из двух его групп
+ResultCache::Slot* ResultCache::find(const VectorKey& key) const {
+    for (Slot* candidates : {group(key.low), group(key.high)}) {
+        for (size_t way = 0; way < ways; ++way) {
+            Slot& slot = candidates[way];
+            if (slot.check != 0 && slot.keyLow == key.low && slot.keyHigh == key.high) {
+                return &slot;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool ResultCache::lookup(const VectorKey& key, int64_t& result) {
+    ++counters.lookups;
+    Slot* slot = find(key);
+    if (slot == nullptr || slot->check != checksum(slot->keyLow, slot->keyHigh, slot->result)) {
+        return false;
+    }
+    // Страница не помечается изменённой без необходимости
+    if (slot->generation != generation) {
+        slot->generation = generation;
+    }
+    result = slot->result;
+    ++counters.hits;
+    return true;
+}
+
+// Новая запись занимает свободную ячейку той из двух групп, где их больше
+void ResultCache::insert(const VectorKey& key, int64_t result) {
+    ++counters.inserts;
+    Slot* target = find(key);
+    if (target == nullptr) {
+        Slot* oldest = nullptr;
+        size_t mostFree = 0;
+        for (Slot* candidates : {group(key.low), group(key.high)}) {
+            size_t free = 0;
+            Slot* firstFree = nullptr;
+            for (size_t way = 0; way < ways; ++way) {
+                Slot& slot = candidates[way];
+                if (slot.check == 0) {
+                    firstFree = firstFree ? firstFree : &slot;
+                    ++free;
+                } else if (oldest == nullptr || slot.generation < oldest->generation) {
+                    oldest = &slot;
+                }
+            }
+            if (free > mostFree) {
+                mostFree = free;
+                target = firstFree;
+            }
+        }
+        if (target != nullptr) {
+            ++header->entries;
+        } else {
+            target = oldest;
+            ++counters.evictions;
+        }
+    }
+
+    // Контрольная сумма пишется последней: оборванная запись ей не соответствует
+    target->keyLow = key.low;
+    target->keyHigh = key.high;
+    target->result = result;
+    target->generation = generation;
+    target->check = checksum(key.low, key.high, result);
+}
+
+size_t ResultCache::entries() const {
+    return header->entries;
+}
+
+size_t ResultCache::fileBytes() const {
+    return sizeof(Header) + slotCount * sizeof(Slot);
+}
@@ -0,0 +1,70 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "VectorHash.h"
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Результаты сервера, сохраняемые между запусками: ключ — хэш содержимого
+// вектора (VectorHash.h), значение — результат. Таблица лежит в файле,
+// отображённом в память, и имеет фиксированный размер: ячейки сгруппированы
+// по 8, ключ может занимать ячейку одной из двух групп (выбираемых по двум
+// половинам ключа), поэтому поиск просматривает не больше 16 ячеек, а группы
+// заполняются равномерно. Если обе группы заполнены, вытесняется запись,
+// дольше всех не использовавшаяся (с точностью до запуска).
+// Файл используется одним процессом (flock); изменения попадают в файл
+// без явной записи, обрывок записи при аварии отбрасывается по контрольной сумме.
+//
+// Формат файла (числа в порядке байтов хоста):
+//   char magic[4] = "VRC1"; uint32_t generation; uint64_t slots; uint64_t entries;
+//   дополнение до 64 байт; затем slots ячеек по 32 байта:
+//   uint64_t keyLow, keyHigh; int64_t result; uint32_t generation; uint32_t check.
+class ResultCache {
+public:
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;
+    };
+
+    // Открытие или создание кэша размером около maxBytes. Если существующий
+    // файл другого размера, записи переносятся в таблицу нового размера
+    // (при уменьшении остаются недавно использованные)
+    ResultCache(const std::string& path, size_t maxBytes);
+    ~ResultCache();
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    bool lookup(const VectorKey& key, int64_t& result);
+    void insert(const VectorKey& key, int64_t result);
+
+    size_t entries() const;
+    size_t capacity() const { return slotCount; }
+    size_t fileBytes() const;
+    const Stats& stats() const { return counters; }
+
+private:
+    struct Header;
+    struct Slot;
+
+    std::string path;
+    int fd;
+    char* mapping;
+    Header* header;
+    Slot* slots;
+    size_t slotCount;
+    uint32_t generation;
+    Stats counters;
+
+    void map(size_t slots);
+    void unmap();
+    void initialize(size_t slots);
+    void resize(size_t slots);
+    Slot* group(uint64_t hash) const;
+    Slot* find(const VectorKey& key) const;
+};
+
+#endif // RESULT_CACHE_H
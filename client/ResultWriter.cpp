@@ -0,0 +1,109 @@
+#include "ResultWriter.h"
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+ResultWriter::ResultWriter(const std::string& path, ElementType type)
+    : path(path), elementType(type), width(elementWidth(type)), fd(-1), mapping(nullptr), resultCount(0) {}
+
+ResultWriter::~ResultWriter() {
+    close();
+}
+
+void ResultWriter::open(size_t count) {
+    close();
+    if (count > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too many results for output file: " + std::to_string(count));
+    }
+    resultCount = count;
+    // Существующий не обычный файл открывается только на запись, как
+    // в ofstream: открытие FIFO ждёт читателя
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && !S_ISREG(info.st_mode)) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::runtime_error("Failed to open output file: " + path + ": " + std::strerror(errno));
+        }
+        openBuffered();
+        return;
+    }
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open output file: " + path + ": " + std::strerror(errno));
+    }
+    // Новый файл заполнен нулями: заголовок — 0, пока не вызван finish.
+    // Если файл нельзя расширить или отобразить, результаты копятся в памяти
+    if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode) || ftruncate(fd, fileBytes()) == -1) {
+        openBuffered();
+        return;
+    }
+    // Блоки выделяются сразу: запись в отображение разреженного файла на
+    // заполненном диске завершила бы процесс сигналом SIGBUS без сообщения
+    int error = posix_fallocate(fd, 0, fileBytes());
+    if (error == ENOSPC || error == EDQUOT || error == EFBIG) {
+        close();
+        throw std::runtime_error("Not enough space for output file: " + path + ": " + std::strerror(error));
+    }
+    if (error != 0) {
+        openBuffered();
+        return;
+    }
+    void* region = mmap(nullptr, fileBytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        openBuffered();
+        return;
+    }
+    mapping = static_cast<char*>(region);
+}
+
+void ResultWriter::openBuffered() {
+    buffer.assign(fileBytes(), 0);
+    mapping = buffer.data();
+}
+
+void ResultWriter::finish() {
+    if (!isOpen()) {
+        throw std::runtime_error("Output file is not open: " + path);
+    }
+    uint32_t count = resultCount;
+    std::memcpy(mapping, &count, sizeof(count));
+    if (!mapped()) {
+        writeBuffered();
+    }
+    close();
+}
+
+void ResultWriter::writeBuffered() {
+    const char* data = buffer.data();
+    size_t left = buffer.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd, data, left);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int error = errno;
+            close();
+            throw std::runtime_error("Failed to write output file: " + path + ": " + std::strerror(error));
+        }
+        data += written;
+        left -= written;
+    }
+}
+
+void ResultWriter::close() {
+    if (mapped()) {
+        munmap(mapping, fileBytes());
+    }
+    mapping = nullptr;
+    buffer = std::vector<char>();
+    if (fd != -1) {
+        ::close(fd);
+        fd = -1;
+    }
+}
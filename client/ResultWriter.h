@@ -0,0 +1,58 @@
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include "ElementType.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Файл результатов (формат writeResults, DataWriter.h), который заполняется
+// по мере прихода результатов. Файл сразу получает полный размер и место
+// на диске и отображается в память; каждый результат записывается на своё
+// место без системного вызова. Количество в заголовке записывает finish — до этого
+// там 0, и незавершённый файл отличим от готового. Принятые результаты
+// остаются в файле, даже если процесс аварийно завершится.
+// Выход, который нельзя отобразить (/dev/stdout, канал, FIFO), получает
+// результаты в буфере памяти; finish записывает его целиком, начиная
+// с заголовка.
+// set для разных индексов можно вызывать из разных потоков одновременно.
+class ResultWriter {
+public:
+    // Файл создаётся или усекается при open
+    ResultWriter(const std::string& path, ElementType type);
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    // Создание файла на count результатов (все нулевые)
+    void open(size_t count);
+    bool isOpen() const { return mapping != nullptr; }
+    size_t count() const { return resultCount; }
+
+    // Результат index в ячейке (ElementType.h)
+    void set(size_t index, int64_t slot) {
+        encodeSlot(slot, elementType, mapping + sizeof(uint32_t) + index * width);
+    }
+
+    // Запись количества в заголовок и закрытие файла
+    void finish();
+
+private:
+    std::string path;
+    ElementType elementType;
+    size_t width;
+    int fd;
+    char* mapping;              // Отображение файла или buffer.data()
+    std::vector<char> buffer;   // Результаты для выхода без отображения
+    size_t resultCount;
+
+    size_t fileBytes() const { return sizeof(uint32_t) + resultCount * width; }
+    bool mapped() const { return mapping != nullptr && buffer.empty(); }
+    void openBuffered();
+    void writeBuffered();
+    void close();
+};
+
+#endif // RESULT_WRITER_H
@@ -0,0 +1,167 @@
+#include "SessionPool.h"
+#include <stdexcept>
+#include <chrono>
+
+namespace {
+
+// Цикл событий выбранного типа; если io_uring недоступен в ядре, используется epoll
+std::unique_ptr<EventEngine> createEngine(const std::string& name, Logger& logger) {
+    EventEngine::Backend backend;
+    EventEngine::parseBackend(name, backend);
+    try {
+        return EventEngine::create(backend);
+    } catch (const std::exception& ex) {
+        if (backend == EventEngine::Backend::Epoll) {
+            throw;
+        }
+        logger.warning(std::string(ex.what()) + ", using epoll");
+        return EventEngine::create(EventEngine::Backend::Epoll);
+    }
+}
+
+} // namespace
+
+void authenticateAsClient(Communicator& comm, const SessionPool::Authenticator& authenticator, int timeoutMs) {
+    // Срок общий на весь обмен: каждое ожидание получает остаток
+    int previousTimeout = comm.timeout();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    auto limitNext = [&]() {
+        if (timeoutMs <= 0) {
+            return;
+        }
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            throw TimeoutError("Authentication timed out after " + std::to_string(timeoutMs) + " ms");
+        }
+        comm.setTimeout(static_cast<int>(left.count()));
+    };
+
+    try {
+        std::string username = "user";
+        limitNext();
+        comm.sendMessage(username);
+
+        std::string salt(16, '\0');
+        limitNext();
+        comm.receiveMessage(salt.data(), 16);
+
+        limitNext();
+        comm.sendMessage(authenticator(salt));
+
+        char response[2];
+        limitNext();
+        comm.receiveMessage(response, sizeof(response));
+        if (std::string(response, 2) != "OK") {
+            throw std::runtime_error("Authentication failed");
+        }
+    } catch (const TimeoutError&) {
+        throw TimeoutError("Authentication timed out after " + std::to_string(timeoutMs) + " ms");
+    }
+    comm.setTimeout(previousTimeout);
+}
+
+SessionPool::SessionPool(const UserInterface& options, Logger& logger, Authenticator authenticator)
+    : options(options), logger(logger), authenticator(std::move(authenticator)) {}
+
+SessionPool::~SessionPool() {
+    close();
+}
+
+void SessionPool::close() {
+    runner.reset();
+    connections.clear();
+    asyncConnections.clear();
+    engine.reset();
+}
+
+bool SessionPool::healthy() const {
+    for (const auto& comm : connections) {
+        if (comm->peerClosed()) {
+            return false;
+        }
+    }
+    for (const auto& session : asyncConnections) {
+        if (session->peerClosed()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SessionPool::open() {
+    if (isOpen()) {
+        if (healthy()) {
+            return;
+        }
+        close();
+    }
+
+    try {
+        if (options.engine == "threads") {
+            openThreaded();
+        } else {
+            openEvents();
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+void SessionPool::openThreaded() {
+    std::vector<Communicator*> sessions;
+    bool zeroCopyWarned = false;
+    for (unsigned i = 0; i < options.connections; ++i) {
+        auto comm = std::make_unique<Communicator>(options.serverAddress, options.serverPort);
+        comm->setTimeout(options.connectTimeout);
+        comm->connectToServer();
+        authenticateAsClient(*comm, authenticator, options.authTimeout);
+        comm->setTimeout(options.vectorTimeout);
+
+        if (options.zeroCopyThreshold > 0 && !comm->enableZeroCopy() && !zeroCopyWarned) {
+            logger.warning("zero-copy send is not supported, using regular send");
+            zeroCopyWarned = true;
+        }
+        sessions.push_back(comm.get());
+        connections.push_back(std::move(comm));
+    }
+    runner = std::make_unique<JobRunner>(options, logger, sessions);
+}
+
+// Подключение и аутентификация всех сессий идут в цикле событий параллельно
+void SessionPool::openEvents() {
+    if (options.zeroCopyThreshold > 0) {
+        logger.warning("zero-copy send requires the threads engine, using regular send");
+    }
+
+    engine = createEngine(options.engine, logger);
+    std::vector<AsyncSession*> sessions;
+    for (unsigned i = 0; i < options.connections; ++i) {
+        asyncConnections.push_back(
+            std::make_unique<AsyncSession>(options.serverAddress, options.serverPort, authenticator));
+        asyncConnections.back()->setTimeouts(options.connectTimeout, options.authTimeout, options.vectorTimeout);
+        asyncConnections.back()->start();
+        sessions.push_back(asyncConnections.back().get());
+    }
+    runner = std::make_unique<JobRunner>(options, logger, sessions, *engine);
+    runner->connect();
+}
+
+std::vector<int64_t> SessionPool::run(const std::string& inputFile, const std::vector<int64_t>& completed,
+                                      Checkpoint* checkpoint, ResultWriter* output) {
+    if (!isOpen()) {
+        throw std::runtime_error("No server connections");
+    }
+    try {
+        return runner->run(inputFile, completed, checkpoint, output);
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+void SessionPool::printStats(size_t vectors) {
+    if (runner) {
+        runner->printStats(vectors);
+    }
+}
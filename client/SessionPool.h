@@ -0,0 +1,61 @@
+#ifndef SESSION_POOL_H
+#define SESSION_POOL_H
+
+#include "UserInterface.h"
+#include "Communicator.h"
+#include "AsyncSession.h"
+#include "EventEngine.h"
+#include "JobRunner.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Аутентифицированные соединения с сервером, которые переживают несколько
+// заданий: рукопожатие выполняется при открытии, а не на каждый файл.
+// Тип соединений (потоки или цикл событий) задаёт options.engine.
+class SessionPool {
+public:
+    // Ответ на соль сервера
+    using Authenticator = AsyncSession::Authenticator;
+
+    // logger получает предупреждения пула и всё, что выводят задания
+    SessionPool(const UserInterface& options, Logger& logger, Authenticator authenticator);
+    ~SessionPool();
+
+    // Подключение и аутентификация options.connections соединений.
+    // Уже открытый пул проверяется: если сервер закрыл простаивающее
+    // соединение, все соединения открываются заново
+    void open();
+    void close();
+    bool isOpen() const { return runner != nullptr; }
+
+    // Обработка файла на соединениях пула (параметры — как у JobRunner::run);
+    // после ошибки пул закрывается, и следующий open подключается заново
+    std::vector<int64_t> run(const std::string& inputFile, const std::vector<int64_t>& completed = {},
+                             Checkpoint* checkpoint = nullptr, ResultWriter* output = nullptr);
+
+    void printStats(size_t vectors);
+
+    // Тип элементов векторов и результатов (-t)
+    ElementType elementType() const { return options.elementType; }
+
+private:
+    const UserInterface& options;
+    Logger& logger;
+    Authenticator authenticator;
+    std::unique_ptr<EventEngine> engine;
+    std::vector<std::unique_ptr<Communicator>> connections;
+    std::vector<std::unique_ptr<AsyncSession>> asyncConnections;
+    std::unique_ptr<JobRunner> runner;
+
+    bool healthy() const;
+    void openThreaded();
+    void openEvents();
+};
+
+// Аутентификация по протоколу сервера на блокирующем соединении.
+// timeoutMs ограничивает всю аутентификацию (0 — без ограничения)
+void authenticateAsClient(Communicator& comm, const SessionPool::Authenticator& authenticator, int timeoutMs = 0);
+
+#endif // SESSION_POOL_H
@@ -1,8 +1,86 @@
 #include "UserInterface.h"
+#include "EventEngine.h"
+#include "LatencyMonitor.h"
+#include "VectorCompute.h"
+#include "Logger.h"
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+
+// Коды длинных опций без короткого эквивалента
+enum LongOption {
+    OPT_MAX_MEMORY = 256,
+    OPT_ZEROCOPY,
+    OPT_ENGINE,
+    OPT_DAEMON,
+    OPT_CHECKPOINT,
+    OPT_RESUME,
+    OPT_CONNECT_TIMEOUT,
+    OPT_AUTH_TIMEOUT,
+    OPT_VECTOR_TIMEOUT,
+    OPT_SLOW_SERVER,
+    OPT_SLOW_FACTOR,
+    OPT_SLOW_PERCENTILE,
+    OPT_OFFLINE,
+    OPT_VERIFY,
+    OPT_OPERATION,
+    OPT_CACHE,
+    OPT_CACHE_SIZE,
+    OPT_DEDUP,
+    OPT_DEDUP_MEMORY,
+    OPT_LOG_LEVEL,
+    OPT_LOG_FORMAT,
+};
+
+// Период контрольных точек при --resume без --checkpoint
+const unsigned defaultCheckpointInterval = 10;
+
+// Пределы числовых параметров: больше не имеет смысла и исчерпывает
+// потоки, дескрипторы или память
+const unsigned maxParseThreads = 1024;
+const unsigned maxWindow = 1 << 20;
+const unsigned maxConnections = 1024;
+const unsigned maxCheckpointInterval = 86400;
+
+UserInterface::UserInterface(int argc, char** argv)
+    : serverPort(33333), configFile("~/.config/vclient.conf"), elementType(ElementType::Int64), streamMode(false), maxMemory(64 << 20),
+      parseThreads(0), window(1), zeroCopyThreshold(0), connections(1), engine("threads"),
+      checkpointInterval(0), resume(false), connectTimeout(10000), authTimeout(10000), vectorTimeout(0),
+      slowServer("warn"), slowFactor(4), slowPercentile(99), offline(false), verifyRate(0), operation("sum"),
+      cacheSize(64 << 20), dedup(false), dedupMemory(64 << 20),
+      logLevel("info"), logFormat("text") {
+    static const option longOptions[] = {
+        {"stream", no_argument, nullptr, 's'},
+        {"max-memory", required_argument, nullptr, OPT_MAX_MEMORY},
+        {"threads", required_argument, nullptr, 'T'},
+        {"window", required_argument, nullptr, 'w'},
+        {"zerocopy", required_argument, nullptr, OPT_ZEROCOPY},
+        {"connections", required_argument, nullptr, 'j'},
+        {"engine", required_argument, nullptr, OPT_ENGINE},
+        {"daemon", required_argument, nullptr, OPT_DAEMON},
+        {"checkpoint", required_argument, nullptr, OPT_CHECKPOINT},
+        {"resume", no_argument, nullptr, OPT_RESUME},
+        {"connect-timeout", required_argument, nullptr, OPT_CONNECT_TIMEOUT},
+        {"auth-timeout", required_argument, nullptr, OPT_AUTH_TIMEOUT},
+        {"vector-timeout", required_argument, nullptr, OPT_VECTOR_TIMEOUT},
+        {"slow-server", required_argument, nullptr, OPT_SLOW_SERVER},
+        {"slow-factor", required_argument, nullptr, OPT_SLOW_FACTOR},
+        {"slow-percentile", required_argument, nullptr, OPT_SLOW_PERCENTILE},
+        {"offline", no_argument, nullptr, OPT_OFFLINE},
+        {"verify", required_argument, nullptr, OPT_VERIFY},
+        {"operation", required_argument, nullptr, OPT_OPERATION},
+        {"cache", required_argument, nullptr, OPT_CACHE},
+        {"cache-size", required_argument, nullptr, OPT_CACHE_SIZE},
+        {"dedup", no_argument, nullptr, OPT_DEDUP},
+        {"dedup-memory", required_argument, nullptr, OPT_DEDUP_MEMORY},
+        {"log-level", required_argument, nullptr, OPT_LOG_LEVEL},
+        {"log-format", required_argument, nullptr, OPT_LOG_FORMAT},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
 
-UserInterface::UserInterface(int argc, char** argv) : serverPort(33333), configFile("~/.config/vclient.conf") {
     int opt;
-    while ((opt = getopt(argc, argv, "a:p:i:o:c:h")) != -1) {
+    while ((opt = getopt_long(argc, argv, "a:p:i:o:c:t:hsT:w:j:", longOptions, nullptr)) != -1) {
         switch (opt) {
             case 'a':
                 serverAddress = optarg;
@@ -19,6 +97,121 @@ UserInterface::UserInterface(int argc, char** argv) : serverPort(33333), configF
             case 'c':
                 configFile = optarg;
                 break;
+            case 't':
+                if (!parseElementType(optarg, elementType)) {
+                    handleError(std::string("Unknown element type: ") + optarg);
+                }
+                break;
+            case 's':
+                streamMode = true;
+                break;
+            case OPT_MAX_MEMORY:
+                maxMemory = parseSize(optarg);
+                streamMode = true;
+                break;
+            case 'T':
+                parseThreads = parseCount(optarg, "number of threads", 0, maxParseThreads);
+                break;
+            case 'w':
+                window = parseCount(optarg, "window", 1, maxWindow);
+                break;
+            case OPT_ZEROCOPY:
+                zeroCopyThreshold = parseSize(optarg);
+                break;
+            case 'j':
+                connections = parseCount(optarg, "number of connections", 1, maxConnections);
+                break;
+            case OPT_ENGINE: {
+                EventEngine::Backend backend;
+                engine = optarg;
+                if (engine != "threads" && !EventEngine::parseBackend(engine, backend)) {
+                    handleError("Unknown engine: " + engine);
+                }
+                break;
+            }
+            case OPT_DAEMON:
+                daemonSocket = optarg;
+                break;
+            case OPT_CHECKPOINT:
+                checkpointInterval = parseCount(optarg, "checkpoint interval", 1, maxCheckpointInterval);
+                break;
+            case OPT_RESUME:
+                resume = true;
+                break;
+            case OPT_CONNECT_TIMEOUT:
+                connectTimeout = parseMilliseconds(optarg);
+                break;
+            case OPT_AUTH_TIMEOUT:
+                authTimeout = parseMilliseconds(optarg);
+                break;
+            case OPT_VECTOR_TIMEOUT:
+                vectorTimeout = parseMilliseconds(optarg);
+                break;
+            case OPT_SLOW_SERVER: {
+                LatencyMonitor::Action action;
+                slowServer = optarg;
+                if (!LatencyMonitor::parseAction(slowServer, action)) {
+                    handleError("Unknown slow server action: " + slowServer);
+                }
+                break;
+            }
+            case OPT_SLOW_FACTOR:
+                slowFactor = parseReal(optarg, "slow server factor");
+                if (slowFactor <= 1) {
+                    handleError("Slow server factor must be greater than 1.");
+                }
+                break;
+            case OPT_SLOW_PERCENTILE:
+                slowPercentile = parseReal(optarg, "percentile");
+                if (slowPercentile <= 0 || slowPercentile > 100) {
+                    handleError("Percentile must be in (0, 100].");
+                }
+                break;
+            case OPT_OFFLINE:
+                offline = true;
+                break;
+            case OPT_VERIFY:
+                verifyRate = parseReal(optarg, "verify rate");
+                if (verifyRate <= 0 || verifyRate > 1) {
+                    handleError("Verify rate must be in (0, 1].");
+                }
+                break;
+            case OPT_OPERATION: {
+                VectorCompute::Operation parsed;
+                operation = optarg;
+                if (!VectorCompute::parseOperation(operation, parsed)) {
+                    handleError("Unknown operation: " + operation);
+                }
+                break;
+            }
+            case OPT_CACHE:
+                cacheFile = optarg;
+                break;
+            case OPT_CACHE_SIZE:
+                cacheSize = parseSize(optarg);
+                break;
+            case OPT_DEDUP:
+                dedup = true;
+                break;
+            case OPT_DEDUP_MEMORY:
+                dedupMemory = parseSize(optarg);
+                break;
+            case OPT_LOG_LEVEL: {
+                Logger::Level parsed;
+                logLevel = optarg;
+                if (!Logger::parseLevel(logLevel, parsed)) {
+                    handleError("Unknown log level: " + logLevel);
+                }
+                break;
+            }
+            case OPT_LOG_FORMAT: {
+                Logger::Format parsed;
+                logFormat = optarg;
+                if (!Logger::parseFormat(logFormat, parsed)) {
+                    handleError("Unknown log format: " + logFormat);
+                }
+                break;
+            }
             case 'h':
                 printHelp();
                 std::exit(0);
@@ -28,7 +221,23 @@ UserInterface::UserInterface(int argc, char** argv) : serverPort(33333), configF
         }
     }
 
-    if (serverAddress.empty() || inputFile.empty() || outputFile.empty()) {
+    // Продолженный запуск тоже может прерваться — его ход сохраняется
+    if (resume && checkpointInterval == 0) {
+        checkpointInterval = defaultCheckpointInterval;
+    }
+
+    // Количество векторов сообщается серверу до разбора файла
+    if (dedup && streamMode) {
+        handleError("Deduplication needs the whole file and cannot be used with --stream.");
+    }
+
+    if (offline && !daemonSocket.empty()) {
+        handleError("Offline mode cannot be used with --daemon.");
+    }
+
+    // В фоновом режиме файлы задаются в каждом задании, без сервера адрес не нужен
+    bool filesRequired = daemonSocket.empty();
+    if ((serverAddress.empty() && !offline) || (filesRequired && (inputFile.empty() || outputFile.empty()))) {
         handleError("Missing required parameters.");
     }
 }
@@ -36,11 +245,43 @@ UserInterface::UserInterface(int argc, char** argv) : serverPort(33333), configF
 void UserInterface::printHelp() {
     std::cout << "Usage: client -a <server_address> -p <server_port> -i <input_file> -o <output_file> -c <config_file>\n";
     std::cout << "Options:\n";
-    std::cout << "  -a server      Server address (required)\n";
+    std::cout << "  -a server      Server address (required): IPv4 address or unix:/path for a local Unix socket\n";
     std::cout << "  -p port        Server port (optional, default: 33333)\n";
     std::cout << "  -i input_file  Input file name (required)\n";
     std::cout << "  -o output_file Output file name (required)\n";
     std::cout << "  -c config_file Configuration file with LOGIN and PASSWORD (optional, default: ~/.config/vclient.conf)\n";
+    std::cout << "  -t type        Element type of vectors and results: int32, int64, uint64 or double\n";
+    std::cout << "                 (default: int64)\n";
+    std::cout << "  -s, --stream   Parse and send vectors concurrently without loading the whole file\n";
+    std::cout << "                 (pipes, FIFOs and compressed input are first copied to a temporary file in $TMPDIR)\n";
+    std::cout << "  --max-memory N Memory budget for queued vectors in stream mode, suffixes K/M/G (default: 64M)\n";
+    std::cout << "  -T, --threads N Threads for parsing the input file (default: 0, all cores)\n";
+    std::cout << "  -w, --window N Vectors in flight before waiting for results (default: 1)\n";
+    std::cout << "  --zerocopy N   Send vectors of at least N bytes with MSG_ZEROCOPY, suffixes K/M/G\n";
+    std::cout << "  -j, --connections N Parallel authenticated connections to the server (default: 1)\n";
+    std::cout << "  --engine NAME  Connection handling: threads (blocking, one thread per connection),\n";
+    std::cout << "                 epoll or io_uring (all connections in one event loop) (default: threads)\n";
+    std::cout << "  --daemon PATH  Keep connections authenticated and accept jobs from vclient-submit\n";
+    std::cout << "                 on the Unix socket PATH (-i and -o are not used)\n";
+    std::cout << "  --checkpoint N Save progress to <output_file>.ckpt every N seconds and on failure\n";
+    std::cout << "  --resume       Continue from <output_file>.ckpt, sending only unfinished vectors\n";
+    std::cout << "  --connect-timeout MS  Limit for connecting to the server (default: 10000, 0 - no limit)\n";
+    std::cout << "  --auth-timeout MS     Limit for the whole authentication (default: 10000, 0 - no limit)\n";
+    std::cout << "  --vector-timeout MS   Limit for waiting for the next result while vectors are in flight\n";
+    std::cout << "                        (default: 0, no limit)\n";
+    std::cout << "  --slow-server ACTION  Response slower than the rolling percentile: off, warn or abort\n";
+    std::cout << "                        (default: warn)\n";
+    std::cout << "  --slow-factor F       Slow response is F times the percentile (default: 4)\n";
+    std::cout << "  --slow-percentile P   Percentile of the last 1024 responses (default: 99)\n";
+    std::cout << "  --offline      Compute results locally without connecting to the server\n";
+    std::cout << "  --verify RATE  Recompute a fraction RATE (0..1] of server results locally and stop on mismatch\n";
+    std::cout << "  --operation OP Server operation for --offline and --verify: sum, product or mean (default: sum)\n";
+    std::cout << "  --cache FILE   Keep server results in FILE between runs and send only vectors not found there\n";
+    std::cout << "  --cache-size N Cache file size limit, suffixes K/M/G; older entries are evicted (default: 64M)\n";
+    std::cout << "  --dedup        Send repeated vectors of the input file once and copy their result\n";
+    std::cout << "  --dedup-memory N Memory for finding repeats, suffixes K/M/G (default: 64M)\n";
+    std::cout << "  --log-level L  Output detail: error, warn, info (summary) or debug (every result) (default: info)\n";
+    std::cout << "  --log-format F Output format: text or json (one JSON object per line) (default: text)\n";
     std::cout << "  -h             Display help\n";
 }
 
@@ -48,3 +289,87 @@ void UserInterface::handleError(const std::string& message) {
     std::cerr << "Error: " << message << std::endl;
     std::exit(1);
 }
+
+size_t UserInterface::parseSize(const std::string& value) {
+    // stoull пропускает пробелы и принимает знак: "-1" стало бы огромным числом
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) {
+        handleError("Invalid size: " + value);
+    }
+    size_t pos = 0;
+    unsigned long long size = 0;
+    try {
+        size = std::stoull(value, &pos);
+    } catch (const std::exception&) {
+        handleError("Invalid size: " + value);
+    }
+
+    std::string suffix = value.substr(pos);
+    unsigned shift = 0;
+    if (suffix == "K" || suffix == "k") {
+        shift = 10;
+    } else if (suffix == "M" || suffix == "m") {
+        shift = 20;
+    } else if (suffix == "G" || suffix == "g") {
+        shift = 30;
+    } else if (!suffix.empty()) {
+        handleError("Invalid size: " + value);
+    }
+    if (size > (SIZE_MAX >> shift)) {
+        handleError("Size is too large: " + value);
+    }
+    size <<= shift;
+
+    if (size == 0) {
+        handleError("Size must be positive: " + value);
+    }
+    return static_cast<size_t>(size);
+}
+
+unsigned UserInterface::parseMilliseconds(const std::string& value) {
+    size_t pos = 0;
+    unsigned long milliseconds = 0;
+    try {
+        milliseconds = std::stoul(value, &pos);
+    } catch (const std::exception&) {
+        handleError("Invalid timeout: " + value);
+    }
+    if (pos != value.size() || milliseconds > 86400000) {
+        handleError("Invalid timeout: " + value);
+    }
+    return static_cast<unsigned>(milliseconds);
+}
+
+unsigned UserInterface::parseCount(const std::string& value, const std::string& name, unsigned minimum, unsigned maximum) {
+    std::string message = "Invalid " + name + ": " + value + " (expected " + std::to_string(minimum) + ".." +
+                          std::to_string(maximum) + ")";
+    // stoul пропускает пробелы и принимает знак: "-1" стало бы огромным числом
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) {
+        handleError(message);
+    }
+    size_t pos = 0;
+    unsigned long count = 0;
+    try {
+        count = std::stoul(value, &pos);
+    } catch (const std::exception&) {
+        handleError(message);
+    }
+    if (pos != value.size() || count < minimum || count > maximum) {
+        handleError(message);
+    }
+    return static_cast<unsigned>(count);
+}
+
+double UserInterface::parseReal(const std::string& value, const std::string& name) {
+    size_t pos = 0;
+    double number = 0;
+    try {
+        number = std::stod(value, &pos);
+    } catch (const std::exception&) {
+        handleError("Invalid " + name + ": " + value);
+    }
+    // nan не отсекается сравнениями с границами диапазона
+    if (pos != value.size() || !std::isfinite(number)) {
+        handleError("Invalid " + name + ": " + value);
+    }
+    return number;
+}
@@ -1,6 +1,7 @@
 #ifndef USER_INTERFACE_H
 #define USER_INTERFACE_H
 
+#include "ElementType.h"
 #include <string>
 #include <iostream>
 #include <stdexcept>
@@ -14,10 +15,42 @@ public:
     std::string inputFile;      // Имя файла с исходными данными
     std::string outputFile;     // Имя файла для сохранения результатов
     std::string configFile;     // Имя файла с LOGIN и PASSWORD
+    ElementType elementType;    // Тип элементов векторов и результатов
+    bool streamMode;            // Потоковая обработка: чтение и отправка одновременно
+    size_t maxMemory;           // Бюджет памяти очереди векторов в потоковом режиме (байт)
+    unsigned parseThreads;      // Потоков разбора входного файла (0 — по числу ядер)
+    unsigned window;            // Максимум векторов, отправленных без полученного результата
+    size_t zeroCopyThreshold;   // Векторы от этого размера (байт) отправляются с MSG_ZEROCOPY (0 — выкл.)
+    unsigned connections;       // Число параллельных соединений с сервером
+    std::string engine;         // Обслуживание соединений: threads, epoll или io_uring
+    std::string daemonSocket;   // Фоновый режим: сокет Unix для приёма заданий (пусто — выкл.)
+    unsigned checkpointInterval; // Период сохранения контрольной точки, секунд (0 — выкл.)
+    bool resume;                // Продолжение с контрольной точки <outputFile>.ckpt
+    unsigned connectTimeout;    // Ограничение подключения, мс (0 — без ограничения)
+    unsigned authTimeout;       // Ограничение аутентификации, мс (0 — без ограничения)
+    unsigned vectorTimeout;     // Ограничение ожидания результата, мс (0 — без ограничения)
+    std::string slowServer;     // Реакция на медленные ответы: off, warn или abort
+    double slowFactor;          // Медленный ответ — дольше slowFactor процентиля slowPercentile
+    double slowPercentile;
+    bool offline;               // Вычисление результатов локально, без сервера
+    double verifyRate;          // Доля результатов сервера, проверяемых локально (0 — выкл.)
+    std::string operation;      // Операция сервера для локального вычисления: sum, product или mean
+    std::string cacheFile;      // Файл кэша результатов между запусками (пусто — выкл.)
+    size_t cacheSize;           // Предельный размер файла кэша (байт)
+    bool dedup;                 // Повторы векторов файла не отправляются
+    size_t dedupMemory;         // Память на поиск повторов (байт)
+    std::string logLevel;       // Подробность вывода: error, warn, info (сводка) или debug (и каждый результат)
+    std::string logFormat;      // Формат вывода: text или json (JSON Lines)
 
     UserInterface(int argc, char** argv);
     static void printHelp();
     static void handleError(const std::string& message);
+    static size_t parseSize(const std::string& value);
+    static unsigned parseMilliseconds(const std::string& value);
+    // Целое число от minimum до maximum без знака и лишних символов
+    static unsigned parseCount(const std::string& value, const std::string& name, unsigned minimum, unsigned maximum);
+    // Конечное число без лишних символов; диапазон проверяет вызывающий
+    static double parseReal(const std::string& value, const std::string& name);
 };
 
 #endif // USER_INTERFACE_H
@@ -0,0 +1,45 @@
+#include "VectorBatch.h"
+
+VectorBatch::VectorBatch(ElementType type) : offsets(1, 0), elementType(type), width(elementWidth(type)) {
+    dispatchElement(type, [this](auto tag) { values.emplace<std::vector<typename decltype(tag)::type>>(); });
+}
+
+void VectorBatch::append(VectorView vec) {
+    std::visit(
+        [&vec](auto& v) {
+            using T = typename std::decay_t<decltype(v)>::value_type;
+            v.insert(v.end(), vec.values<T>(), vec.values<T>() + vec.size);
+        },
+        values);
+    closeVector();
+}
+
+void VectorBatch::append(const VectorBatch& other) {
+    size_t base = totalValues();
+    std::visit(
+        [&other](auto& v) {
+            using Values = std::decay_t<decltype(v)>;
+            const Values& source = std::get<Values>(other.values);
+            v.insert(v.end(), source.begin(), source.end());
+        },
+        values);
+    offsets.reserve(offsets.size() + other.size());
+    for (size_t i = 1; i < other.offsets.size(); ++i) {
+        offsets.push_back(base + other.offsets[i]);
+    }
+}
+
+void VectorBatch::reserve(size_t vectors, size_t totalValues) {
+    offsets.reserve(vectors + 1);
+    std::visit([totalValues](auto& v) { v.reserve(totalValues); }, values);
+}
+
+void VectorBatch::clear() {
+    std::visit([](auto& v) { v.clear(); }, values);
+    offsets.resize(1);
+}
+
+size_t VectorBatch::memoryBytes() const {
+    size_t capacity = std::visit([](const auto& v) { return v.capacity(); }, values);
+    return capacity * width + offsets.capacity() * sizeof(size_t);
+}
@@ -0,0 +1,81 @@
+#ifndef VECTOR_BATCH_H
+#define VECTOR_BATCH_H
+
+#include "ElementType.h"
+#include <vector>
+#include <variant>
+#include <cstdint>
+#include <cstddef>
+
+// Невладеющее представление одного вектора внутри VectorBatch:
+// size элементов по width байт (тип элементов известен владельцу)
+struct VectorView {
+    const void* data;
+    size_t size;
+    size_t width;
+
+    size_t bytes() const { return size * width; }
+    template <class T>
+    const T* values() const { return static_cast<const T*>(data); }
+};
+
+// Набор векторов в формате CSR: все элементы лежат подряд в одном массиве,
+// границы векторов хранятся в массиве смещений (offsets.size() == size() + 1).
+// Добавление вектора не выделяет память, кроме амортизированного роста массивов.
+// Тип элементов задаётся при создании; массив элементов типизирован,
+// поэтому разбор и вычисления работают без преобразований.
+class VectorBatch {
+    std::variant<std::vector<int64_t>, std::vector<int32_t>, std::vector<uint64_t>, std::vector<double>> values;
+    std::vector<size_t> offsets;
+    ElementType elementType;
+    size_t width;
+
+    const char* base() const {
+        return std::visit([](const auto& v) { return reinterpret_cast<const char*>(v.data()); }, values);
+    }
+
+public:
+    class Iterator {
+        const VectorBatch* batch;
+        size_t index;
+
+    public:
+        Iterator(const VectorBatch* batch, size_t index) : batch(batch), index(index) {}
+        VectorView operator*() const { return (*batch)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+    explicit VectorBatch(ElementType type = ElementType::Int64);
+
+    ElementType type() const { return elementType; }
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return offsets.size() == 1; }
+    size_t totalValues() const { return offsets.back(); }
+    size_t totalBytes() const { return offsets.back() * width; }
+
+    VectorView operator[](size_t index) const {
+        return {base() + offsets[index] * width, offsets[index + 1] - offsets[index], width};
+    }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+    // Добавление вектора по месту: элементы дописываются в openVector<T>()
+    // (T — тип элементов набора), после чего closeVector() фиксирует границу
+    template <class T>
+    std::vector<T>& openVector() { return std::get<std::vector<T>>(values); }
+    void closeVector() {
+        offsets.push_back(std::visit([](const auto& v) { return v.size(); }, values));
+    }
+
+    // Векторы должны быть того же типа, что и набор
+    void append(VectorView vec);
+    void append(const VectorBatch& other);
+    void reserve(size_t vectors, size_t totalValues);
+    void clear();
+
+    // Объём занимаемой памяти (по ёмкости массивов)
+    size_t memoryBytes() const;
+};
+
+#endif // VECTOR_BATCH_H
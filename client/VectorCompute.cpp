@@ -0,0 +1,357 @@
+#include "VectorCompute.h"
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define VECTOR_COMPUTE_X86 1
+#endif
+
+namespace {
+
+// Меньше стольких элементов на поток вычисление не распараллеливается
+const size_t minValuesPerThread = 1 << 20;
+
+// Чтение элемента без требований к выравниванию
+template <class T>
+inline T load(const T* data, size_t index) {
+    T value;
+    std::memcpy(&value, reinterpret_cast<const char*>(data) + index * sizeof(value), sizeof(value));
+    return value;
+}
+
+template <class T>
+inline bool isNegative(T value) {
+    if constexpr (std::is_signed_v<T>) {
+        return value < 0;
+    } else {
+        return false;
+    }
+}
+
+template <class T>
+inline std::make_unsigned_t<T> magnitudeOf(T value) {
+    using U = std::make_unsigned_t<T>;
+    return isNegative(value) ? U(0) - static_cast<U>(value) : static_cast<U>(value);
+}
+
+// Итог произведения по модулю и знаку точного результата
+template <class T>
+T finishProduct(std::make_unsigned_t<T> magnitude, bool negative, bool overflow) {
+    using U = std::make_unsigned_t<T>;
+    U limit = negative ? U(0) - static_cast<U>(std::numeric_limits<T>::min()) : std::numeric_limits<T>::max();
+    if (overflow || magnitude > limit) {
+        return negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+    return negative ? static_cast<T>(U(0) - magnitude) : static_cast<T>(magnitude);
+}
+
+// Умножение модулей до первого переполнения или нуля; возвращает
+// позицию, с которой продолжать
+template <class T>
+size_t multiplyUntilOverflow(const T* data, size_t size, std::make_unsigned_t<T>& magnitude, bool& negative,
+                             bool& zero, bool& overflow) {
+    for (size_t i = 0; i < size; ++i) {
+        T value = load(data, i);
+        if (value == 0) {
+            zero = true;
+            return size;
+        }
+        negative ^= isNegative(value);
+        if (__builtin_mul_overflow(magnitude, magnitudeOf(value), &magnitude)) {
+            overflow = true;
+            return i + 1;
+        }
+    }
+    return size;
+}
+
+// Целые складываются по модулю 2^N, double — по порядку элементов
+template <class T>
+T sumScalar(const T* data, size_t size) {
+    if constexpr (std::is_floating_point_v<T>) {
+        T sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += load(data, i);
+        }
+        return sum;
+    } else {
+        using U = std::make_unsigned_t<T>;
+        U sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += static_cast<U>(load(data, i));
+        }
+        return static_cast<T>(sum);
+    }
+}
+
+// После переполнения модуль результата уже больше любого значения типа,
+// и значение определяют только наличие нуля и знак
+template <class T>
+T productScalar(const T* data, size_t size) {
+    if constexpr (std::is_floating_point_v<T>) {
+        T product = 1;
+        for (size_t i = 0; i < size; ++i) {
+            product *= load(data, i);
+        }
+        return product;
+    } else {
+        std::make_unsigned_t<T> magnitude = 1;
+        bool negative = false;
+        bool zero = false;
+        bool overflow = false;
+        size_t i = multiplyUntilOverflow(data, size, magnitude, negative, zero, overflow);
+        if (zero) {
+            return 0;
+        }
+        for (; i < size; ++i) {
+            T value = load(data, i);
+            if (value == 0) {
+                return 0;
+            }
+            negative ^= isNegative(value);
+        }
+        return finishProduct<T>(magnitude, negative, overflow);
+    }
+}
+
+// Сумма целых точная (128 бит), поэтому среднее не зависит от переполнения
+template <class T>
+T meanScalar(const T* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        return sumScalar(data, size) / static_cast<T>(size);
+    } else {
+        using Wide = std::conditional_t<std::is_signed_v<T>, __int128, unsigned __int128>;
+        Wide sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += load(data, i);
+        }
+        return static_cast<T>(sum / static_cast<Wide>(size));
+    }
+}
+
+// Ядро над элементами T с результатом в ячейке (ElementType.h)
+template <class T, T (*Kernel)(const T*, size_t)>
+int64_t slotKernel(const void* data, size_t size) {
+    return toSlot(Kernel(static_cast<const T*>(data), size));
+}
+
+template <class T>
+VectorCompute::Function scalarKernel(VectorCompute::Operation operation) {
+    switch (operation) {
+        case VectorCompute::Operation::Sum:
+            return slotKernel<T, sumScalar<T>>;
+        case VectorCompute::Operation::Product:
+            return slotKernel<T, productScalar<T>>;
+        default:
+            return slotKernel<T, meanScalar<T>>;
+    }
+}
+
+#ifdef VECTOR_COMPUTE_X86
+__attribute__((target("avx2")))
+uint64_t horizontalSum(__m256i v) {
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(half)) + static_cast<uint64_t>(_mm_extract_epi64(half, 1));
+}
+
+// Два независимых накопителя скрывают задержку сложения; скорость
+// ограничена чтением памяти
+__attribute__((target("avx2")))
+int64_t sumAvx2(const int64_t* data, size_t size) {
+    __m256i first = _mm256_setzero_si256();
+    __m256i second = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        first = _mm256_add_epi64(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        second = _mm256_add_epi64(second, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 4)));
+    }
+    uint64_t sum = horizontalSum(_mm256_add_epi64(first, second));
+    for (; i < size; ++i) {
+        sum += static_cast<uint64_t>(load(data, i));
+    }
+    return static_cast<int64_t>(sum);
+}
+
+// Умножение модулей скалярное (в AVX2 нет 64-битного умножения),
+// поиск нулей и подсчёт отрицательных после переполнения — векторные
+__attribute__((target("avx2")))
+int64_t productAvx2(const int64_t* data, size_t size) {
+    uint64_t magnitude = 1;
+    bool negative = false;
+    bool zero = false;
+    bool overflow = false;
+    size_t i = multiplyUntilOverflow(data, size, magnitude, negative, zero, overflow);
+    if (zero) {
+        return 0;
+    }
+
+    const __m256i zeroes = _mm256_setzero_si256();
+    __m256i anyZero = _mm256_setzero_si256();
+    __m256i negatives = _mm256_setzero_si256();
+    for (; i + 4 <= size; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        anyZero = _mm256_or_si256(anyZero, _mm256_cmpeq_epi64(v, zeroes));
+        negatives = _mm256_sub_epi64(negatives, _mm256_cmpgt_epi64(zeroes, v));
+    }
+    if (!_mm256_testz_si256(anyZero, anyZero)) {
+        return 0;
+    }
+    negative ^= horizontalSum(negatives) & 1;
+    for (; i < size; ++i) {
+        int64_t value = load(data, i);
+        if (value == 0) {
+            return 0;
+        }
+        negative ^= value < 0;
+    }
+    return finishProduct<int64_t>(magnitude, negative, overflow);
+}
+
+// Точная сумма без 128-битных сложений в цикле: младшие и старшие
+// 32 бита (без знака) суммируются отдельно, знак учитывается числом
+// отрицательных элементов: x = hi * 2^32 + lo - [x < 0] * 2^64.
+// Длина вектора меньше 2^32, поэтому 64-битные накопители не переполняются
+__attribute__((target("avx2")))
+int64_t meanAvx2(const int64_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    const __m256i zeroes = _mm256_setzero_si256();
+    const __m256i lowMask = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i low = _mm256_setzero_si256();
+    __m256i high = _mm256_setzero_si256();
+    __m256i negatives = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        low = _mm256_add_epi64(low, _mm256_and_si256(v, lowMask));
+        high = _mm256_add_epi64(high, _mm256_srli_epi64(v, 32));
+        negatives = _mm256_sub_epi64(negatives, _mm256_cmpgt_epi64(zeroes, v));
+    }
+
+    alignas(32) uint64_t lanes[3][4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), low);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), high);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), negatives);
+    __int128 sum = 0;
+    for (int lane = 0; lane < 4; ++lane) {
+        sum += static_cast<__int128>(lanes[0][lane]) + (static_cast<__int128>(lanes[1][lane]) << 32) -
+               (static_cast<__int128>(lanes[2][lane]) << 64);
+    }
+    for (; i < size; ++i) {
+        sum += load(data, i);
+    }
+    return static_cast<int64_t>(sum / static_cast<__int128>(size));
+}
+#endif
+
+} // namespace
+
+// Векторные ядра есть только для int64; для остальных типов скалярные
+// циклы без ветвлений векторизует компилятор
+VectorCompute::VectorCompute(Operation operation, ElementType type, Kernel kernel)
+    : activeOperation(operation), elementType(type), activeKernel(kernel) {
+#ifndef VECTOR_COMPUTE_X86
+    activeKernel = Kernel::Scalar;
+#else
+    if (type != ElementType::Int64) {
+        activeKernel = Kernel::Scalar;
+    }
+    if (activeKernel == Kernel::AVX2) {
+        switch (operation) {
+            case Operation::Sum:
+                function = slotKernel<int64_t, sumAvx2>;
+                break;
+            case Operation::Product:
+                function = slotKernel<int64_t, productAvx2>;
+                break;
+            default:
+                function = slotKernel<int64_t, meanAvx2>;
+                break;
+        }
+        return;
+    }
+#endif
+    function = dispatchElement(type, [operation](auto tag) {
+        return scalarKernel<typename decltype(tag)::type>(operation);
+    });
+}
+
+VectorCompute::Kernel VectorCompute::detectKernel() {
+#ifdef VECTOR_COMPUTE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::AVX2;
+    }
+#endif
+    return Kernel::Scalar;
+}
+
+const char* VectorCompute::kernelName(Kernel kernel) {
+    return kernel == Kernel::AVX2 ? "avx2" : "scalar";
+}
+
+const char* VectorCompute::operationName(Operation operation) {
+    switch (operation) {
+        case Operation::Sum:
+            return "sum";
+        case Operation::Product:
+            return "product";
+        default:
+            return "mean";
+    }
+}
+
+bool VectorCompute::parseOperation(const std::string& name, Operation& operation) {
+    for (Operation candidate : {Operation::Sum, Operation::Product, Operation::Mean}) {
+        if (name == operationName(candidate)) {
+            operation = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Векторы делятся между потоками на диапазоны с примерно равным числом элементов
+std::vector<int64_t> VectorCompute::computeAll(const VectorBatch& vectors, unsigned threads) const {
+    std::vector<int64_t> results(vectors.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(
+        std::max<size_t>(1, std::min<size_t>(threads, vectors.totalValues() / minValuesPerThread)));
+
+    auto work = [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            results[i] = compute(vectors[i]);
+        }
+    };
+    if (threads == 1) {
+        work(0, vectors.size());
+        return results;
+    }
+
+    std::vector<std::thread> workers;
+    size_t share = vectors.totalValues() / threads + 1;
+    size_t from = 0;
+    size_t values = 0;
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        values += vectors[i].size;
+        if (values >= share * (workers.size() + 1) && workers.size() + 1 < threads) {
+            workers.emplace_back(work, from, i + 1);
+            from = i + 1;
+        }
+    }
+    work(from, vectors.size());
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
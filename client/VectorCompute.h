@@ -0,0 +1,55 @@
+#ifndef VECTOR_COMPUTE_H
+#define VECTOR_COMPUTE_H
+
+#include "VectorBatch.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Локальное вычисление операции сервера над вектором — для работы без
+// сервера и выборочной проверки его результатов. Результат имеет тип
+// элементов (в ячейке, ElementType.h). Поведение целых типов при
+// переполнении определено и одинаково во всех ядрах:
+//   sum     — сумма по модулю 2^N (как у сервера);
+//   product — произведение, при переполнении насыщается до
+//             наибольшего или наименьшего значения типа по знаку
+//             точного результата;
+//   mean    — точная сумма, делённая на длину с отбрасыванием дробной
+//             части (к нулю); для пустого вектора — 0.
+// double вычисляется в обычной арифметике по порядку элементов.
+// Пустой вектор: сумма 0, произведение 1. Векторное ядро (AVX2, только
+// для int64) выбирается во время выполнения; данные могут быть не выровнены.
+class VectorCompute {
+public:
+    enum class Operation { Sum, Product, Mean };
+    enum class Kernel { Scalar, AVX2 };
+
+    using Function = int64_t (*)(const void* data, size_t size);
+
+    explicit VectorCompute(Operation operation = Operation::Sum, ElementType type = ElementType::Int64,
+                           Kernel kernel = detectKernel());
+
+    static Kernel detectKernel();
+    static const char* kernelName(Kernel kernel);
+    static const char* operationName(Operation operation);
+    // Разбор названия операции: sum, product или mean
+    static bool parseOperation(const std::string& name, Operation& operation);
+
+    Operation operation() const { return activeOperation; }
+    ElementType type() const { return elementType; }
+    Kernel kernel() const { return activeKernel; }
+
+    int64_t compute(VectorView vec) const { return function(vec.data, vec.size); }
+
+    // Результаты всех векторов, вычисленные в threads потоках (0 — по числу ядер)
+    std::vector<int64_t> computeAll(const VectorBatch& vectors, unsigned threads) const;
+
+private:
+    Operation activeOperation;
+    ElementType elementType;
+    Kernel activeKernel;
+    Function function;
+};
+
+#endif // VECTOR_COMPUTE_H
@@ -0,0 +1,74 @@
+#include "VectorDedup.h"
+
+namespace {
+
+const size_t minCapacity = 16;
+
+} // namespace
+
+// Половина памяти отводится таблице (заполнение не больше 3/4), остальное — повторам
+VectorDedup::VectorDedup(size_t vectors, size_t maxBytes) : used(0), overflow(false) {
+    size_t capacity = minCapacity;
+    while (capacity / 4 * 3 < vectors && capacity * 2 * sizeof(Entry) <= maxBytes / 2) {
+        capacity *= 2;
+    }
+    table.assign(capacity, Entry{0, 0, 0});
+    maxEntries = capacity / 4 * 3;
+    size_t tableBytes = capacity * sizeof(Entry);
+    maxPairs = maxBytes > tableBytes ? (maxBytes - tableBytes) / sizeof(Pair) : 0;
+}
+
+// Линейное пробирование: ячейка с ключом или первая пустая
+VectorDedup::Entry& VectorDedup::slot(const VectorKey& key) {
+    size_t mask = table.size() - 1;
+    size_t i = key.low & mask;
+    while (table[i].position != 0 && (table[i].low != key.low || table[i].high != key.high)) {
+        i = (i + 1) & mask;
+    }
+    return table[i];
+}
+
+bool VectorDedup::duplicate(const VectorKey& key, size_t index) {
+    if (pairs.size() >= maxPairs) {
+        overflow = true;
+        return false;
+    }
+    Entry& entry = slot(key);
+    if (entry.position == 0) {
+        return false;
+    }
+    pairs.push_back({entry.position - 1, static_cast<uint32_t>(index)});
+    return true;
+}
+
+void VectorDedup::add(const VectorKey& key, size_t position) {
+    if (used >= maxEntries) {
+        overflow = true;
+        return;
+    }
+    Entry& entry = slot(key);
+    if (entry.position == 0) {
+        entry = {key.low, key.high, static_cast<uint32_t>(position + 1)};
+        ++used;
+    }
+}
+
+// Сортировка повторов по позиции подсчётом
+void VectorDedup::collect(size_t positions, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices) const {
+    offsets.assign(positions + 1, 0);
+    for (const Pair& pair : pairs) {
+        ++offsets[pair.position + 1];
+    }
+    for (size_t p = 0; p < positions; ++p) {
+        offsets[p + 1] += offsets[p];
+    }
+    // offsets[p] служит курсором позиции p и после раскладки указывает на конец её повторов
+    indices.resize(pairs.size());
+    for (const Pair& pair : pairs) {
+        indices[offsets[pair.position]++] = pair.index;
+    }
+    for (size_t p = positions; p > 0; --p) {
+        offsets[p] = offsets[p - 1];
+    }
+    offsets[0] = 0;
+}
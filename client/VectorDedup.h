@@ -0,0 +1,54 @@
+#ifndef VECTOR_DEDUP_H
+#define VECTOR_DEDUP_H
+
+#include "VectorHash.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Поиск повторяющихся векторов одного файла перед отправкой. Каждый
+// отправляемый вектор получает позицию отправки; повтор уже отправляемого
+// вектора не отправляется, а получает результат его позиции.
+// Таблица ключей (открытая адресация) и список повторов занимают не больше
+// maxBytes: когда место кончается, новые векторы отправляются без проверки
+class VectorDedup {
+public:
+    // vectors — сколько векторов будет проверено (по нему выбирается размер таблицы)
+    VectorDedup(size_t vectors, size_t maxBytes);
+
+    // Если вектор с таким ключом уже отправляется, вектор index
+    // записывается его повтором и возвращается true
+    bool duplicate(const VectorKey& key, size_t index);
+    // Запоминание ключа вектора, отправляемого на позиции position
+    void add(const VectorKey& key, size_t position);
+
+    // Повторы по позициям отправки: результат позиции p нужен векторам
+    // indices[offsets[p]] ... indices[offsets[p + 1] - 1]
+    void collect(size_t positions, std::vector<uint32_t>& offsets, std::vector<uint32_t>& indices) const;
+
+    size_t duplicates() const { return pairs.size(); }
+    // Часть векторов не проверялась из-за ограничения памяти
+    bool limited() const { return overflow; }
+
+private:
+    struct Entry {
+        uint64_t low;
+        uint64_t high;
+        uint32_t position;  // Позиция отправки + 1, 0 — пустая ячейка
+    };
+    struct Pair {
+        uint32_t position;
+        uint32_t index;
+    };
+
+    std::vector<Entry> table;
+    size_t used;
+    size_t maxEntries;
+    std::vector<Pair> pairs;
+    size_t maxPairs;
+    bool overflow;
+
+    Entry& slot(const VectorKey& key);
+};
+
+#endif // VECTOR_DEDUP_H
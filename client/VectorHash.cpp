@@ -0,0 +1,64 @@
+#include "VectorHash.h"
+#include <cstring>
+
+namespace {
+
+// Нечётные константы с хорошо перемешанными битами
+const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t prime3 = 0x165667B19E3779F9ULL;
+const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t secret[5] = {
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL,
+    0x1F67B3B7A4A44072ULL, 0x78E5C0CC4EE679CBULL,
+};
+
+inline uint64_t load(const char* data, size_t index) {
+    uint64_t value;
+    std::memcpy(&value, data + index * sizeof(value), sizeof(value));
+    return value;
+}
+
+// Произведение 64x64->128, свёрнутое в 64 бита
+inline uint64_t fold(uint64_t a, uint64_t b) {
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace
+
+VectorKey hashVector(VectorView vec, uint64_t seed) {
+    const char* data = static_cast<const char*>(vec.data);
+    size_t size = vec.size;
+    size_t words = vec.bytes() / sizeof(uint64_t);
+    // Позиция блока входит в перемножаемые значения, поэтому хэш зависит
+    // от порядка элементов, а сложение не удлиняет цепочку зависимостей
+    uint64_t first = size * prime1 + seed;
+    uint64_t second = size ^ prime2;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        first += fold(load(data, i) ^ secret[0], load(data, i + 1) ^ (secret[1] + i));
+        second += fold(load(data, i + 2) ^ secret[2], load(data, i + 3) ^ (secret[3] - i));
+    }
+    for (; i < words; ++i) {
+        first += fold(load(data, i) ^ secret[4], prime4 + i);
+    }
+    // Последние четыре байта нечётного числа элементов int32
+    if (vec.bytes() % sizeof(uint64_t) != 0) {
+        uint32_t tail;
+        std::memcpy(&tail, data + words * sizeof(uint64_t), sizeof(tail));
+        second += fold(tail ^ secret[2], prime2 + words);
+    }
+
+    VectorKey key;
+    key.low = avalanche(first + ((second << 17) | (second >> 47)) + size * prime4);
+    key.high = avalanche(second ^ (first * prime3) ^ size);
+    return key;
+}
@@ -0,0 +1,24 @@
+#ifndef VECTOR_HASH_H
+#define VECTOR_HASH_H
+
+#include "VectorBatch.h"
+#include <cstdint>
+#include <cstddef>
+
+// 128-битный ключ содержимого вектора: при таком размере случайное
+// совпадение ключей разных векторов практически исключено
+struct VectorKey {
+    uint64_t low;
+    uint64_t high;
+
+    bool operator==(const VectorKey& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const VectorKey& other) const { return !(*this == other); }
+};
+
+// Быстрый некриптографический хэш элементов и длины вектора в духе XXH3:
+// на каждые 16 байт одно умножение 64x64->128 со свёрткой, две
+// независимые цепочки накопления. Данные могут быть не выровнены.
+// Хэшируются байты элементов; seed разделяет ключи векторов разных типов
+VectorKey hashVector(VectorView vec, uint64_t seed = 0);
+
+#endif // VECTOR_HASH_H
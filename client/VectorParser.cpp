@@ -0,0 +1,307 @@
+#include "VectorParser.h"
+#include <charconv>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTOR_PARSER_X86 1
+#endif
+
+ParseError::ParseError(const std::string& detail, size_t line, size_t column)
+    : std::runtime_error("Parse error at line " + std::to_string(line) + ", column " + std::to_string(column) +
+                         ": " + detail),
+      errorDetail(detail), errorLine(line), errorColumn(column) {}
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+[[noreturn]] void fail(const char* what, std::string_view token, size_t line, size_t column) {
+    throw ParseError(std::string(what) + " '" + std::string(token) + "'", line, column);
+}
+
+// Преобразование одной лексемы (допускается ведущий '+', как у operator>>)
+template <class T>
+T convertToken(std::string_view token, size_t line, size_t column) {
+    std::string_view digits = token;
+    if (digits.size() > 1 && digits[0] == '+' && digits[1] != '-') {
+        digits.remove_prefix(1);
+    }
+
+    T value = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    if (ec == std::errc::result_out_of_range) {
+        fail((std::string(elementTypeName(elementTypeOf<T>())) + " overflow").c_str(), token, line, column);
+    }
+    if (ec != std::errc() || ptr != digits.data() + digits.size()) {
+        fail("invalid number", token, line, column);
+    }
+    return value;
+}
+
+// Битовые маски классификации строки: бит i соответствует байту i.
+// Позиции за концом строки помечаются как пробельные (стоп-символ).
+thread_local std::vector<uint64_t> spaceMask;
+thread_local std::vector<uint64_t> digitMask;
+
+void classifyTail(const char* p, size_t n, size_t from, uint64_t* space, uint64_t* digit, size_t words) {
+    for (size_t w = from / 64; w < words; ++w) {
+        uint64_t s = 0, d = 0;
+        for (size_t bit = 0; bit < 64; ++bit) {
+            size_t i = w * 64 + bit;
+            if (i >= n) {
+                s |= ~0ULL << bit;
+                break;
+            }
+            s |= static_cast<uint64_t>(isSpace(p[i])) << bit;
+            d |= static_cast<uint64_t>(static_cast<unsigned char>(p[i] - '0') <= 9) << bit;
+        }
+        space[w] = s;
+        digit[w] = d;
+    }
+}
+
+#ifdef VECTOR_PARSER_X86
+__attribute__((target("avx2")))
+void classifyAvx2(const char* p, size_t n, uint64_t* space, uint64_t* digit, size_t words) {
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i ctrlLo = _mm256_set1_epi8('\t' - 1);
+    const __m256i ctrlHi = _mm256_set1_epi8('\r' + 1);
+    const __m256i digitLo = _mm256_set1_epi8('0' - 1);
+    const __m256i digitHi = _mm256_set1_epi8('9' + 1);
+
+    size_t full = n / 64;
+    for (size_t w = 0; w < full; ++w) {
+        uint64_t s = 0, d = 0;
+        for (int half = 0; half < 2; ++half) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + w * 64 + half * 32));
+            __m256i isCtrl = _mm256_and_si256(_mm256_cmpgt_epi8(v, ctrlLo), _mm256_cmpgt_epi8(ctrlHi, v));
+            __m256i isSp = _mm256_or_si256(_mm256_cmpeq_epi8(v, blank), isCtrl);
+            __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(v, digitLo), _mm256_cmpgt_epi8(digitHi, v));
+            s |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(isSp))) << (half * 32);
+            d |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(isDigit))) << (half * 32);
+        }
+        space[w] = s;
+        digit[w] = d;
+    }
+    classifyTail(p, n, full * 64, space, digit, words);
+}
+
+__attribute__((target("sse4.2")))
+void classifySse42(const char* p, size_t n, uint64_t* space, uint64_t* digit, size_t words) {
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i ctrlLo = _mm_set1_epi8('\t' - 1);
+    const __m128i ctrlHi = _mm_set1_epi8('\r' + 1);
+    const __m128i digitLo = _mm_set1_epi8('0' - 1);
+    const __m128i digitHi = _mm_set1_epi8('9' + 1);
+
+    size_t full = n / 64;
+    for (size_t w = 0; w < full; ++w) {
+        uint64_t s = 0, d = 0;
+        for (int quarter = 0; quarter < 4; ++quarter) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + w * 64 + quarter * 16));
+            __m128i isCtrl = _mm_and_si128(_mm_cmpgt_epi8(v, ctrlLo), _mm_cmpgt_epi8(ctrlHi, v));
+            __m128i isSp = _mm_or_si128(_mm_cmpeq_epi8(v, blank), isCtrl);
+            __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(v, digitLo), _mm_cmpgt_epi8(digitHi, v));
+            s |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(isSp))) << (quarter * 16);
+            d |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(isDigit))) << (quarter * 16);
+        }
+        space[w] = s;
+        digit[w] = d;
+    }
+    classifyTail(p, n, full * 64, space, digit, words);
+}
+#endif
+
+// Преобразование ровно восьми ASCII-цифр за три умножения (SWAR, little-endian)
+uint64_t parseEightDigits(const char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    value = ((value & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    value = ((value & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return ((value & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+}
+
+// Наибольшее число десятичных цифр, которое собирается без проверки
+// переполнения (для double — представимое точно)
+template <class T>
+constexpr size_t fastDigits() {
+    if constexpr (std::is_same_v<T, int32_t>) {
+        return 9;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return 19;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return 15;
+    } else {
+        return 18;
+    }
+}
+
+template <class T>
+T applySign(uint64_t magnitude, bool negative) {
+    if constexpr (std::is_unsigned_v<T>) {
+        return magnitude;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return negative ? -static_cast<T>(magnitude) : static_cast<T>(magnitude);
+    } else {
+        return negative ? static_cast<T>(-static_cast<int64_t>(magnitude)) : static_cast<T>(magnitude);
+    }
+}
+
+// Поиск первой позиции >= from, где бит маски равен set
+size_t findBit(const uint64_t* mask, size_t words, size_t from, bool set) {
+    size_t w = from / 64;
+    uint64_t cur = (set ? mask[w] : ~mask[w]) & (~0ULL << (from % 64));
+    while (cur == 0) {
+        if (++w == words) {
+            return words * 64;
+        }
+        cur = set ? mask[w] : ~mask[w];
+    }
+    return w * 64 + __builtin_ctzll(cur);
+}
+
+// Проверка, что все биты в диапазоне [from, to) установлены
+bool allSet(const uint64_t* mask, size_t from, size_t to) {
+    while (from < to) {
+        size_t offset = from % 64;
+        size_t count = std::min<size_t>(64 - offset, to - from);
+        uint64_t want = (count == 64 ? ~0ULL : ((1ULL << count) - 1)) << offset;
+        if ((mask[from / 64] & want) != want) {
+            return false;
+        }
+        from += count;
+    }
+    return true;
+}
+
+} // namespace
+
+VectorParser::VectorParser(Kernel kernel) : activeKernel(kernel) {
+#ifndef VECTOR_PARSER_X86
+    activeKernel = Kernel::Scalar;
+#endif
+}
+
+VectorParser::Kernel VectorParser::detectKernel() {
+#ifdef VECTOR_PARSER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Kernel::SSE42;
+    }
+#endif
+    return Kernel::Scalar;
+}
+
+const char* VectorParser::kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::AVX2:
+            return "avx2";
+        case Kernel::SSE42:
+            return "sse4.2";
+        default:
+            return "scalar";
+    }
+}
+
+template <class T>
+void VectorParser::parseLine(std::string_view line, size_t lineNumber, std::vector<T>& out) const {
+    if (activeKernel == Kernel::Scalar) {
+        parseScalar(line, lineNumber, out);
+    } else {
+        parseClassified(line, lineNumber, out);
+    }
+}
+
+void VectorParser::parseVector(std::string_view line, size_t lineNumber, VectorBatch& batch) const {
+    dispatchElement(batch.type(), [&](auto tag) {
+        parseLine(line, lineNumber, batch.openVector<typename decltype(tag)::type>());
+    });
+    batch.closeVector();
+}
+
+template <class T>
+void VectorParser::parseScalar(std::string_view line, size_t lineNumber, std::vector<T>& out) const {
+    size_t n = line.size();
+    size_t i = 0;
+    while (true) {
+        while (i < n && isSpace(line[i])) {
+            ++i;
+        }
+        if (i == n) {
+            break;
+        }
+        size_t start = i;
+        while (i < n && !isSpace(line[i])) {
+            ++i;
+        }
+        out.push_back(convertToken<T>(line.substr(start, i - start), lineNumber, start + 1));
+    }
+}
+
+template <class T>
+void VectorParser::parseClassified(std::string_view line, size_t lineNumber, std::vector<T>& out) const {
+    size_t n = line.size();
+    size_t words = n / 64 + 1;
+    if (spaceMask.size() < words) {
+        spaceMask.resize(words);
+        digitMask.resize(words);
+    }
+    uint64_t* space = spaceMask.data();
+    uint64_t* digit = digitMask.data();
+
+#ifdef VECTOR_PARSER_X86
+    if (activeKernel == Kernel::AVX2) {
+        classifyAvx2(line.data(), n, space, digit, words);
+    } else {
+        classifySse42(line.data(), n, space, digit, words);
+    }
+#else
+    classifyTail(line.data(), n, 0, space, digit, words);
+#endif
+
+    size_t pos = 0;
+    while (true) {
+        size_t start = findBit(space, words, pos, false);
+        if (start >= n) {
+            break;
+        }
+        size_t end = findBit(space, words, start, true);
+        const char* token = line.data() + start;
+        size_t signLength = (token[0] == '-' || token[0] == '+') ? 1 : 0;
+        size_t digits = end - start - signLength;
+        bool negative = token[0] == '-';
+
+        // До fastDigits цифр переполнение невозможно — быстрый путь без проверок;
+        // отрицательные числа для uint64 и дробные для double идут через from_chars
+        if (digits > 0 && digits <= fastDigits<T>() && !(negative && std::is_unsigned_v<T>) &&
+            allSet(digit, start + signLength, end)) {
+            const char* p = token + signLength;
+            size_t head = digits % 8;
+            uint64_t value = 0;
+            for (size_t i = 0; i < head; ++i) {
+                value = value * 10 + static_cast<uint64_t>(p[i] - '0');
+            }
+            for (size_t i = head; i < digits; i += 8) {
+                value = value * 100000000 + parseEightDigits(p + i);
+            }
+            out.push_back(applySign<T>(value, negative));
+        } else {
+            out.push_back(convertToken<T>(line.substr(start, end - start), lineNumber, start + 1));
+        }
+        pos = end;
+    }
+}
+
+// Специализации для всех типов элементов (ElementType.h)
+template void VectorParser::parseLine(std::string_view, size_t, std::vector<int32_t>&) const;
+template void VectorParser::parseLine(std::string_view, size_t, std::vector<int64_t>&) const;
+template void VectorParser::parseLine(std::string_view, size_t, std::vector<uint64_t>&) const;
+template void VectorParser::parseLine(std::string_view, size_t, std::vector<double>&) const;
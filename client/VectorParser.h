@@ -0,0 +1,59 @@
+#ifndef VECTOR_PARSER_H
+#define VECTOR_PARSER_H
+
+#include "VectorBatch.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+// Ошибка разбора входных данных с указанием позиции
+class ParseError : public std::runtime_error {
+    std::string errorDetail;
+    size_t errorLine;
+    size_t errorColumn;
+
+public:
+    ParseError(const std::string& detail, size_t line, size_t column);
+    const std::string& detail() const { return errorDetail; }
+    size_t line() const { return errorLine; }
+    size_t column() const { return errorColumn; }
+};
+
+// Разбор строк с числами, разделёнными пробельными символами.
+// Скалярное ядро построено на std::from_chars, векторные (SSE4.2/AVX2)
+// классифицируют символы блоками и выбираются во время выполнения.
+// Преобразование чисел специализировано для каждого типа элементов
+// (ElementType.h): короткие числа без знака переполнения собираются
+// без проверок, остальные — через std::from_chars с проверкой диапазона.
+class VectorParser {
+public:
+    enum class Kernel { Scalar, SSE42, AVX2 };
+
+    explicit VectorParser(Kernel kernel = detectKernel());
+
+    static Kernel detectKernel();
+    static const char* kernelName(Kernel kernel);
+    Kernel kernel() const { return activeKernel; }
+
+    // Разбор одной строки; числа добавляются в конец out.
+    // lineNumber (с единицы) используется только в сообщениях об ошибках.
+    // T — int32_t, int64_t, uint64_t или double
+    template <class T>
+    void parseLine(std::string_view line, size_t lineNumber, std::vector<T>& out) const;
+
+    // Разбор строки в новый вектор batch (с типом элементов batch)
+    void parseVector(std::string_view line, size_t lineNumber, VectorBatch& batch) const;
+
+private:
+    Kernel activeKernel;
+
+    template <class T>
+    void parseScalar(std::string_view line, size_t lineNumber, std::vector<T>& out) const;
+    template <class T>
+    void parseClassified(std::string_view line, size_t lineNumber, std::vector<T>& out) const;
+};
+
+#endif // VECTOR_PARSER_H
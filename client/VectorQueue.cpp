@@ -0,0 +1,83 @@
+#include "VectorQueue.h"
+
+VectorQueue::VectorQueue(size_t budgetBytes)
+    : budget(budgetBytes), usedBytes(0), peak(0), closed(false) {}
+
+bool VectorQueue::push(VectorBatch&& batch) {
+    size_t bytes = batch.memoryBytes();
+    std::unique_lock<std::mutex> lock(mutex);
+    // Пачка больше всего бюджета допускается только в пустую очередь
+    notFull.wait(lock, [&] { return closed || items.empty() || usedBytes + bytes <= budget; });
+    if (closed) {
+        return false;
+    }
+
+    usedBytes += bytes;
+    if (usedBytes > peak) {
+        peak = usedBytes;
+    }
+    items.push_back(std::move(batch));
+    notEmpty.notify_one();
+    if (listener) {
+        listener();
+    }
+    return true;
+}
+
+bool VectorQueue::pop(VectorBatch& batch) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [&] { return closed || !items.empty(); });
+    return take(batch);
+}
+
+bool VectorQueue::tryPop(VectorBatch& batch, bool& finished) {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = closed && items.empty();
+    return (closed || !items.empty()) && take(batch);
+}
+
+bool VectorQueue::take(VectorBatch& batch) {
+    if (items.empty()) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return false;
+    }
+
+    batch = std::move(items.front());
+    items.pop_front();
+    usedBytes -= batch.memoryBytes();
+    notFull.notify_one();
+    return true;
+}
+
+void VectorQueue::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+    if (listener) {
+        listener();
+    }
+}
+
+void VectorQueue::fail(std::exception_ptr producerError) {
+    std::lock_guard<std::mutex> lock(mutex);
+    error = producerError;
+    closed = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+    if (listener) {
+        listener();
+    }
+}
+
+void VectorQueue::setListener(std::function<void()> onChange) {
+    std::lock_guard<std::mutex> lock(mutex);
+    listener = std::move(onChange);
+}
+
+size_t VectorQueue::peakBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peak;
+}
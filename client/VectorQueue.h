@@ -0,0 +1,53 @@
+#ifndef VECTOR_QUEUE_H
+#define VECTOR_QUEUE_H
+
+#include "VectorBatch.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <cstddef>
+
+// Очередь пачек векторов между потоком чтения и потоком отправки.
+// Объём данных в очереди ограничен бюджетом в байтах: производитель
+// блокируется, пока потребитель не освободит место (обратное давление).
+class VectorQueue {
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<VectorBatch> items;
+    size_t budget;
+    size_t usedBytes;
+    size_t peak;
+    bool closed;
+    std::exception_ptr error;
+    std::function<void()> listener;
+
+    // Извлечение первой пачки под захваченным мьютексом
+    bool take(VectorBatch& batch);
+
+public:
+    explicit VectorQueue(size_t budgetBytes);
+
+    // Возвращает false, если очередь уже закрыта потребителем
+    bool push(VectorBatch&& batch);
+
+    // Возвращает false после закрытия и опустошения очереди;
+    // пробрасывает исключение производителя, если оно было
+    bool pop(VectorBatch& batch);
+
+    // Неблокирующий pop: false, если пачки пока нет; finished становится
+    // true, когда очередь закрыта и опустошена
+    bool tryPop(VectorBatch& batch, bool& finished);
+
+    // Уведомление о новой пачке или закрытии очереди — для потребителя,
+    // который ждёт не на условной переменной, а в цикле событий
+    void setListener(std::function<void()> onChange);
+
+    void close();
+    void fail(std::exception_ptr producerError);
+    size_t peakBytes();
+};
+
+#endif // VECTOR_QUEUE_H
@@ -0,0 +1,203 @@
+#include "VectorSender.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+namespace {
+// Векторы не длиннее порога копируются в общий буфер отправки
+const size_t copyThreshold = 4096;
+// Накопленные данные отправляются, как только их становится больше
+const size_t flushThreshold = 256 * 1024;
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+}
+
+VectorSender::VectorSender(Communicator& comm, unsigned window, size_t zeroCopyThreshold)
+    : comm(comm), window(window == 0 ? 1 : window), zeroCopyThreshold(zeroCopyThreshold), monitor(nullptr),
+      elementType(ElementType::Int64), staged(0) {
+    staging.reserve(flushThreshold + copyThreshold + sizeof(uint32_t));
+}
+
+void VectorSender::appendVector(VectorView vec) {
+    uint32_t vectorSize = vec.size;
+    const char* header = reinterpret_cast<const char*>(&vectorSize);
+    staging.insert(staging.end(), header, header + sizeof(vectorSize));
+    ++staged;
+
+    const char* payload = reinterpret_cast<const char*>(vec.data);
+    if (vec.bytes() <= copyThreshold) {
+        staging.insert(staging.end(), payload, payload + vec.bytes());
+        if (staging.size() >= flushThreshold) {
+            flush();
+        }
+        return;
+    }
+
+    // Крупный вектор уходит сразу вместе с накопленным буфером:
+    // представление действительно только до следующего обращения к источнику.
+    // sendZeroCopy возвращается, когда ядро уже не ссылается на страницы.
+    if (zeroCopyThreshold > 0 && vec.bytes() >= zeroCopyThreshold && comm.zeroCopyAvailable()) {
+        flush();
+        comm.sendZeroCopy(payload, vec.bytes());
+        return;
+    }
+
+    iovec iov[2] = {
+        {staging.data(), staging.size()},
+        {const_cast<char*>(payload), vec.bytes()},
+    };
+    markSending();
+    comm.sendv(iov, 2);
+    staging.clear();
+}
+
+void VectorSender::flush() {
+    if (!staging.empty()) {
+        markSending();
+        comm.sendMessage(staging.data(), staging.size());
+        staging.clear();
+    }
+}
+
+void VectorSender::markSending() {
+    if (beforeSend && staged > 0) {
+        beforeSend(staged);
+    }
+    staged = 0;
+}
+
+int64_t VectorSender::receiveResult() {
+    char result[sizeof(int64_t)];
+    comm.receiveMessage(result, elementWidth(elementType));
+    return decodeSlot(result, elementType);
+}
+
+void VectorSender::run(uint32_t count, const Source& source, const Sink& sink) {
+    // Количество уходит одним вызовом с первыми векторами
+    const char* header = reinterpret_cast<const char*>(&count);
+    staging.insert(staging.end(), header, header + sizeof(count));
+    if (count == 0) {
+        flush();
+        return;
+    }
+    if (window == 1) {
+        runSequential(count, source, sink);
+    } else {
+        runPipelined(count, source, sink);
+    }
+}
+
+void VectorSender::runSequential(uint32_t count, const Source& source, const Sink& sink) {
+    VectorView vec{};
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!source(vec)) {
+            throw std::runtime_error("Input ended after " + std::to_string(i) + " of " + std::to_string(count) + " vectors");
+        }
+        Clock::time_point sentAt = monitor ? Clock::now() : Clock::time_point();
+        appendVector(vec);
+        flush();
+        int64_t result = receiveResult();
+        if (monitor) {
+            monitor->record(millisecondsSince(sentAt));
+        }
+        sink(i, result);
+    }
+}
+
+void VectorSender::runPipelined(uint32_t count, const Source& source, const Sink& sink) {
+    std::mutex mutex;
+    std::condition_variable slotFree;
+    uint32_t inFlight = 0;
+    bool aborted = false;
+    std::exception_ptr senderError;
+    // Время отправки векторов в полёте (только при учёте времени ответа).
+    // Отметка ставится перед системным вызовом, который отправляет вектор,
+    // поэтому разбор, ожидание очереди и копирование в неё не входят, а
+    // результат не может прийти раньше своей отметки
+    std::deque<Clock::time_point> sendTimes;
+    if (monitor) {
+        beforeSend = [&](uint32_t vectors) {
+            Clock::time_point now = Clock::now();
+            std::lock_guard<std::mutex> lock(mutex);
+            sendTimes.insert(sendTimes.end(), vectors, now);
+        };
+    }
+
+    std::thread sender([&]() {
+        try {
+            VectorView vec{};
+            uint32_t i = 0;
+            while (i < count) {
+                // Все свободные места окна занимаются сразу, и векторы
+                // группы уходят минимальным числом системных вызовов
+                uint32_t group;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    slotFree.wait(lock, [&] { return aborted || inFlight < window; });
+                    if (aborted) {
+                        return;
+                    }
+                    group = std::min(window - inFlight, count - i);
+                    inFlight += group;
+                }
+                for (uint32_t end = i + group; i < end; ++i) {
+                    if (!source(vec)) {
+                        throw std::runtime_error("Input ended after " + std::to_string(i) + " of " +
+                                                 std::to_string(count) + " vectors");
+                    }
+                    appendVector(vec);
+                }
+                flush();
+            }
+        } catch (...) {
+            senderError = std::current_exception();
+            // Разблокировать приёмник, ожидающий результата, который не придёт
+            comm.shutdown();
+        }
+    });
+
+    try {
+        for (uint32_t i = 0; i < count; ++i) {
+            int64_t result = receiveResult();
+            Clock::time_point sentAt;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --inFlight;
+                if (monitor) {
+                    sentAt = sendTimes.front();
+                    sendTimes.pop_front();
+                }
+            }
+            slotFree.notify_one();
+            if (monitor) {
+                monitor->record(millisecondsSince(sentAt));
+            }
+            sink(i, result);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+        }
+        slotFree.notify_one();
+        comm.shutdown();
+        sender.join();
+        beforeSend = nullptr;
+        // Первопричина — ошибка отправителя, если она была
+        if (senderError) {
+            std::rethrow_exception(senderError);
+        }
+        throw;
+    }
+    sender.join();
+    beforeSend = nullptr;
+}
@@ -0,0 +1,56 @@
+#ifndef VECTOR_SENDER_H
+#define VECTOR_SENDER_H
+
+#include "Communicator.h"
+#include "VectorBatch.h"
+#include "LatencyMonitor.h"
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Передача набора векторов по одному соединению и приём результатов.
+// Протокол строго упорядочен, поэтому при window > 1 отдельный поток
+// отправляет векторы, держа в полёте не более window неподтверждённых,
+// а вызывающий поток принимает результаты по порядку.
+// Количество, заголовки и небольшие векторы копируются в общий буфер и уходят одним
+// системным вызовом; крупные векторы передаются без копирования через sendv,
+// а векторы от zeroCopyThreshold байт — через MSG_ZEROCOPY, если он включён.
+class VectorSender {
+public:
+    // Источник векторов: заполняет vec и возвращает true, либо false в конце.
+    // Представление должно оставаться действительным до следующего вызова.
+    using Source = std::function<bool(VectorView& vec)>;
+    // Получатель результатов: индекс вектора (с нуля) и результат
+    using Sink = std::function<void(size_t index, int64_t result)>;
+
+    VectorSender(Communicator& comm, unsigned window, size_t zeroCopyThreshold = 0);
+
+    // Учёт времени ответа на каждый вектор (nullptr — без учёта)
+    void setMonitor(LatencyMonitor* monitor) { this->monitor = monitor; }
+    // Тип результатов: сервер отвечает значением той же ширины, что и элементы
+    void setElementType(ElementType type) { elementType = type; }
+
+    // Отправляет количество векторов, затем сами векторы из source
+    void run(uint32_t count, const Source& source, const Sink& sink);
+
+private:
+    Communicator& comm;
+    unsigned window;
+    size_t zeroCopyThreshold;
+    LatencyMonitor* monitor;
+    ElementType elementType;
+    std::vector<char> staging;  // Данные, ожидающие отправки
+    uint32_t staged;            // Векторов, чьи заголовки ещё не отправлены
+    // Вызывается перед системным вызовом, отправляющим staged векторов
+    std::function<void(uint32_t vectors)> beforeSend;
+
+    void appendVector(VectorView vec);
+    void flush();
+    void markSending();
+    int64_t receiveResult();
+    void runSequential(uint32_t count, const Source& source, const Sink& sink);
+    void runPipelined(uint32_t count, const Source& source, const Sink& sink);
+};
+
+#endif // VECTOR_SENDER_H
@@ -1,7 +1,12 @@
 #include "UserInterface.h"
-#include "Communicator.h"
-#include "DataReader.h"
 #include "DataWriter.h"
+#include "ResultWriter.h"
+#include "SessionPool.h"
+#include "Daemon.h"
+#include "Checkpoint.h"
+#include "JobRunner.h"
+#include "VectorCompute.h"
+#include "Logger.h"
 #include <cryptopp/cryptlib.h>
 #include <cryptopp/hex.h>
 #include <cryptopp/osrng.h>
@@ -11,12 +16,12 @@
 #include <vector>
 #include <fstream>
 #include <stdexcept>
-#include <iterator>
-#include <sstream>
 #include <cstring>   // Для std::memcpy
+#include <memory>
+#include <chrono>
+#include <sstream>
 
 // Установим статические параметры по умолчанию
-const std::string dataType = "int64_t";
 const std::string hashType = "MD5";
 const std::string saltSide = "server";
 
@@ -35,13 +40,8 @@ void readLoginPassword(const std::string& configFile, std::string& login, std::s
     }
 }
 
-void authenticateAsClient(Communicator& comm, const std::string& password, CryptoPP::HashTransformation& hash) {
-    std::string username = "user";
-    comm.sendMessage(username);
-
-    std::string salt(16, '\0');
-    comm.receiveMessage(salt.data(), 16);
-
+// Ответ на соль сервера: шестнадцатеричный хэш соли и пароля
+std::string hashResponse(const std::string& salt, const std::string& password, CryptoPP::HashTransformation& hash) {
     std::string combined = salt + password;
 
     std::string calculatedHash;
@@ -50,44 +50,40 @@ void authenticateAsClient(Communicator& comm, const std::string& password, Crypt
         new CryptoPP::HashFilter(hash,
                                  new CryptoPP::HexEncoder(
                                      new CryptoPP::StringSink(calculatedHash))));
-
-    comm.sendMessage(calculatedHash);
-
-    char response[2];
-    comm.receiveMessage(response, sizeof(response));
-    if (std::string(response, 2) != "OK") {
-        throw std::runtime_error("Authentication failed");
-    }
+    return calculatedHash;
 }
 
-std::vector<std::vector<int64_t>> readInputFile(const std::string& inputFile) {
-    std::ifstream file(inputFile);
-    if (!file) {
-        throw std::runtime_error("Failed to open input file: " + inputFile);
-    }
-
-    std::vector<std::vector<int64_t>> vectors;
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        vectors.emplace_back((std::istream_iterator<int64_t>(iss)), std::istream_iterator<int64_t>());
-    }
-
-    return vectors;
+Logger::Level logLevel(const UserInterface& ui) {
+    Logger::Level level = Logger::Level::Info;
+    Logger::parseLevel(ui.logLevel, level);
+    return level;
 }
 
-void writeResults(const std::string& outputFile, const std::vector<int64_t>& results) {
-    std::ofstream file(outputFile, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Failed to open output file: " + outputFile);
-    }
-
-    uint32_t numResults = results.size();
-    file.write(reinterpret_cast<const char*>(&numResults), sizeof(numResults));
+Logger::Format logFormat(const UserInterface& ui) {
+    Logger::Format format = Logger::Format::Text;
+    Logger::parseFormat(ui.logFormat, format);
+    return format;
+}
 
-    for (const auto& result : results) {
-        file.write(reinterpret_cast<const char*>(&result), sizeof(result));
+// Вычисление результатов без сервера (--offline)
+std::vector<int64_t> computeOffline(const UserInterface& ui, Logger& logger) {
+    VectorCompute::Operation operation = VectorCompute::Operation::Sum;
+    VectorCompute::parseOperation(ui.operation, operation);
+    VectorCompute compute(operation, ui.elementType);
+
+    VectorBatch vectors = loadInputFile(ui.inputFile, ui.parseThreads, ui.elementType);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int64_t> results = compute.computeAll(vectors, ui.parseThreads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream line;
+    line << "Computed " << results.size() << " vectors locally (" << VectorCompute::operationName(operation)
+         << ", " << elementTypeName(compute.type()) << ", " << VectorCompute::kernelName(compute.kernel()) << "): " << seconds * 1e3 << " ms";
+    if (seconds > 0) {
+        line << ", " << vectors.totalBytes() / seconds / 1e6 << " MB/s";
     }
+    logger.info(line.str());
+    return results;
 }
 
 int main(int argc, char** argv) {
@@ -101,38 +97,64 @@ int main(int argc, char** argv) {
 
         // Чтение параметров из командной строки
         UserInterface ui(argc, argv);
-        Communicator comm(ui.serverAddress, ui.serverPort);
+        // Всё, что выводится дальше, кроме последней ошибки, идёт через журнал
+        Logger logger(logLevel(ui), logFormat(ui), ui.elementType);
 
-        comm.connectToServer();
+        if (ui.offline) {
+            writeResults(ui.outputFile, computeOffline(ui, logger), ui.elementType);
+            return 0;
+        }
 
         // Чтение логина и пароля из файла конфигурации
         std::string login, password;
         readLoginPassword(ui.configFile, login, password);
 
-        // Аутентификация
+        // Аутентификация: ответ на соль сервера — хэш соли и пароля
         CryptoPP::Weak::MD5 md5Hash;
-        authenticateAsClient(comm, password, md5Hash);
-
-        // Чтение данных из файла
-        auto vectors = readInputFile(ui.inputFile);
-        std::vector<int64_t> results;
+        SessionPool pool(ui, logger, [&](const std::string& salt) { return hashResponse(salt, password, md5Hash); });
 
-        uint32_t numVectors = vectors.size();
-        comm.sendMessage(reinterpret_cast<const char*>(&numVectors), sizeof(numVectors));
+        if (!ui.daemonSocket.empty()) {
+            Daemon daemon(pool, logger);
+            daemon.serve(ui.daemonSocket);
+            return 0;
+        }
 
-        for (const auto& vec : vectors) {
-            uint32_t vectorSize = vec.size();
-            comm.sendMessage(reinterpret_cast<const char*>(&vectorSize), sizeof(vectorSize));
-            comm.sendMessage(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(int64_t));
+        // Результаты, сохранённые прерванным запуском
+        std::string checkpointPath = Checkpoint::pathFor(ui.outputFile);
+        std::vector<int64_t> completed;
+        if (ui.resume) {
+            if (Checkpoint::load(checkpointPath, ui.inputFile, ui.elementType, completed)) {
+                logger.info("Resuming from checkpoint: " + std::to_string(completed.size()) + " vectors already done");
+            } else {
+                logger.info("No checkpoint found, starting from the beginning");
+            }
+        }
+        std::unique_ptr<Checkpoint> checkpoint;
+        if (ui.checkpointInterval > 0) {
+            checkpoint = std::make_unique<Checkpoint>(checkpointPath, ui.inputFile, ui.elementType, completed);
+        }
 
-            int64_t result;
-            comm.receiveMessage(reinterpret_cast<char*>(&result), sizeof(result));
-            results.push_back(result);
-            std::cout << "Received result: " << result << std::endl;
+        // Отправка векторов и приём результатов: результаты записываются
+        // в выходной файл по мере прихода
+        ResultWriter output(ui.outputFile, ui.elementType);
+        std::vector<int64_t> results;
+        try {
+            pool.open();
+            results = pool.run(ui.inputFile, completed, checkpoint.get(), &output);
+        } catch (...) {
+            if (checkpoint) {
+                logger.warning("Progress saved to " + checkpointPath + " (" + std::to_string(checkpoint->saved()) +
+                                " vectors done), rerun with --resume to continue");
+            }
+            throw;
         }
+        pool.printStats(results.size() - completed.size());
 
-        // Запись результатов в файл
-        writeResults(ui.outputFile, results);
+        // Запись количества результатов в заголовок файла
+        output.finish();
+        if (checkpoint) {
+            checkpoint->remove();
+        }
 
     } catch (const std::exception& ex) {
         std::cerr << "Error: " << ex.what() << std::endl;
@@ -0,0 +1,76 @@
+#include "DataReader.h"
+#include "VectorParser.h"
+#include "VectorBatch.h"
+#include "BinaryFormat.h"
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <getopt.h>
+
+// Преобразование текстового файла с векторами в двоичный формат (см. BinaryFormat.h)
+
+void printHelp() {
+    std::cout << "Usage: vclient-pack -i <input_file> -o <output_file> [-t type]\n";
+    std::cout << "Options:\n";
+    std::cout << "  -i input_file  Text input file, one vector per line (required)\n";
+    std::cout << "  -o output_file Binary output file (required)\n";
+    std::cout << "  -t type        Element type: int32, int64, uint64 or double (default: int64)\n";
+    std::cout << "  -h             Display help\n";
+}
+
+int main(int argc, char** argv) {
+    std::string inputFile;
+    std::string outputFile;
+    ElementType type = ElementType::Int64;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:t:h")) != -1) {
+        switch (opt) {
+            case 'i':
+                inputFile = optarg;
+                break;
+            case 'o':
+                outputFile = optarg;
+                break;
+            case 't':
+                if (!parseElementType(optarg, type)) {
+                    std::cerr << "Error: Unknown element type: " << optarg << "\n";
+                    return 1;
+                }
+                break;
+            case 'h':
+                printHelp();
+                return 0;
+            default:
+                printHelp();
+                return 1;
+        }
+    }
+
+    if (inputFile.empty() || outputFile.empty()) {
+        std::cerr << "Error: Missing required parameters.\n";
+        printHelp();
+        return 1;
+    }
+
+    try {
+        DataReader reader(inputFile);
+        VectorParser parser;
+        BinaryWriter writer(outputFile, type);
+        VectorBatch line(type);
+        std::string_view text;
+        size_t lineNumber = 0;
+        while (reader.nextLine(text)) {
+            line.clear();
+            parser.parseVector(text, ++lineNumber, line);
+            writer.write(line[0]);
+        }
+        writer.finish();
+        std::cout << "Packed " << lineNumber << " vectors into " << outputFile << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,467 @@
+#include "Communicator.h"
+#include "VectorCompute.h"
+#include <cryptopp/cryptlib.h>
+#include <cryptopp/hex.h>
+#define CRYPTOPP_ENABLE_NAMESPACE_WEAK 1
+#include <cryptopp/md5.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <csignal>
+#include <strings.h>
+#include <getopt.h>
+#include <netinet/tcp.h>
+#include <sys/un.h>
+
+// Эталонный сервер для проверки и замеров клиента на одной машине.
+// Протокол тот же, что у сервера курсовой работы: имя пользователя,
+// соль из 16 символов, MD5 соли и пароля в шестнадцатеричном виде, "OK",
+// затем задания — uint32_t количество векторов и векторы вида
+// uint32_t size, int64_t values[size]; на каждый вектор — int64_t сумма
+// (при переполнении — по модулю 2^64) либо другая операция VectorCompute.
+// С -t значения и результаты имеют другой тип (ElementType.h).
+// Задержка вычисления, её разброс и сбои задаются параметрами.
+
+namespace {
+
+// Внедряемые сбои
+enum class Fault { None, Close, Hang, Corrupt, Stall, Auth };
+
+struct Settings {
+    std::string address = "127.0.0.1";
+    int port = 33333;
+    std::string configFile = "~/.config/vclient.conf";
+    VectorCompute::Operation operation = VectorCompute::Operation::Sum;
+    ElementType type = ElementType::Int64;
+    unsigned delayUs = 0;       // Время вычисления одного вектора, мкс
+    unsigned jitterUs = 0;      // Случайная добавка к задержке, до jitterUs мкс
+    Fault fault = Fault::None;
+    double faultRate = 0;       // Вероятность сбоя на вектор (для auth — на подключение)
+    unsigned stallMs = 1000;    // Длительность сбоя stall
+    uint64_t dropAfter = 0;     // Закрыть соединение после стольких результатов (0 — нет)
+    uint64_t seed = 0;          // Начальное значение генератора (0 — случайное)
+};
+
+// Векторы больше этого отклоняются, чтобы ошибка клиента не исчерпала память
+const uint64_t maxVectorBytes = 1ULL << 30;
+// Задержки короче этой выдерживаются активным ожиданием: sleep_for
+// на микросекундах промахивается на десятки микросекунд
+const auto spinLimit = std::chrono::microseconds(200);
+
+std::mutex logMutex;
+
+void log(const std::string& message) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::cout << message << std::endl;
+}
+
+void printHelp() {
+    std::cout << "Usage: vclient-server -a <address> -p <port> -c <config_file>\n";
+    std::cout << "Options:\n";
+    std::cout << "  -a address     Listen address: IPv4 address or unix:/path (default: 127.0.0.1)\n";
+    std::cout << "  -p port        Listen port (default: 33333)\n";
+    std::cout << "  -c config_file File with LOGIN and PASSWORD accepted from clients\n";
+    std::cout << "                 (default: ~/.config/vclient.conf)\n";
+    std::cout << "  -t type        Element type of vectors and results: int32, int64, uint64 or double\n";
+    std::cout << "                 (default: int64)\n";
+    std::cout << "  --operation OP Result of each vector: sum, product or mean (default: sum)\n";
+    std::cout << "  -d, --delay US Compute time per vector in microseconds (default: 0)\n";
+    std::cout << "  --jitter US    Random extra compute time, up to US microseconds (default: 0)\n";
+    std::cout << "  --fault KIND   Injected fault: close (drop the connection), hang (stop answering),\n";
+    std::cout << "                 corrupt (wrong result), stall (answer after --stall ms),\n";
+    std::cout << "                 auth (reject the login)\n";
+    std::cout << "  --fault-rate R Probability of the fault per vector, per connection for auth\n";
+    std::cout << "                 (default: 1, every time)\n";
+    std::cout << "  --stall MS     Stall duration in milliseconds (default: 1000)\n";
+    std::cout << "  --drop-after N Close each connection after N results\n";
+    std::cout << "  --seed N       Seed for delays and faults, for reproducible runs (default: random)\n";
+    std::cout << "  -h             Display help\n";
+}
+
+bool parseFault(const std::string& name, Fault& fault) {
+    static const std::pair<const char*, Fault> names[] = {
+        {"close", Fault::Close}, {"hang", Fault::Hang}, {"corrupt", Fault::Corrupt},
+        {"stall", Fault::Stall}, {"auth", Fault::Auth},
+    };
+    for (const auto& entry : names) {
+        if (name == entry.first) {
+            fault = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void readLoginPassword(const std::string& configFile, std::string& login, std::string& password) {
+    std::ifstream config(configFile);
+    if (!config) {
+        throw std::runtime_error("Failed to open config file: " + configFile);
+    }
+    std::getline(config, login);
+    std::getline(config, password);
+    if (login.empty() || password.empty()) {
+        throw std::runtime_error("Invalid login or password in config file.");
+    }
+}
+
+std::string md5Hex(const std::string& text) {
+    CryptoPP::Weak::MD5 hash;
+    std::string digest;
+    CryptoPP::StringSource(text, true,
+                           new CryptoPP::HashFilter(hash, new CryptoPP::HexEncoder(new CryptoPP::StringSink(digest))));
+    return digest;
+}
+
+// Клиент закрыл соединение
+class ClientClosed : public std::runtime_error {
+public:
+    ClientClosed() : std::runtime_error("client closed the connection") {}
+};
+
+// Обслуживание одного клиента. Принятые данные читаются крупными блоками;
+// результаты копятся в буфере и отправляются перед каждым ожиданием
+// данных клиента, так что конвейер векторов получает результаты пачками
+class Session {
+public:
+    Session(int fd, const Settings& settings, const std::string& login, const std::string& password, uint64_t seed)
+        : fd(fd), settings(settings), login(login), password(password), compute(settings.operation, settings.type),
+          width(elementWidth(settings.type)), random(seed),
+          inBuffer(64 * 1024), head(0), tail(0), results(0) {}
+
+    ~Session() {
+        ::close(fd);
+    }
+
+    // Возвращает false, если аутентификация не пройдена
+    bool authenticate() {
+        char name[256];
+        ssize_t got;
+        do {
+            got = recv(fd, name, sizeof(name), 0);
+        } while (got == -1 && errno == EINTR);
+        if (got <= 0) {
+            throw ClientClosed();
+        }
+
+        static const char digits[] = "0123456789ABCDEF";
+        std::string salt(16, '0');
+        for (char& c : salt) {
+            c = digits[random() % 16];
+        }
+        send(salt.data(), salt.size());
+        flush();
+
+        std::string response(32, '\0');
+        read(response.data(), response.size());
+        bool accepted = std::string(name, got) == login &&
+                        strcasecmp(response.c_str(), md5Hex(salt + password).c_str()) == 0 && !faultNow(Fault::Auth);
+        send(accepted ? "OK" : "ERR", accepted ? 2 : 3);
+        flush();
+        return accepted;
+    }
+
+    // Приём заданий до закрытия соединения клиентом или внедрённого сбоя
+    void serve() {
+        while (true) {
+            uint32_t count;
+            read(&count, sizeof(count));
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t size;
+                read(&size, sizeof(size));
+                uint64_t bytes = static_cast<uint64_t>(size) * width;
+                if (bytes > maxVectorBytes) {
+                    throw std::runtime_error("vector of " + std::to_string(size) + " values is too large");
+                }
+                fill(bytes);
+                // Данные в буфере не выровнены по ширине элемента — ядра VectorCompute это допускают
+                int64_t result = compute.compute({inBuffer.data() + head, size, width});
+                head += bytes;
+                answer(result);
+            }
+        }
+    }
+
+    uint64_t processed() const { return results; }
+
+private:
+    int fd;
+    const Settings& settings;
+    const std::string& login;
+    const std::string& password;
+    VectorCompute compute;
+    size_t width;                   // Байт на элемент и на результат
+    std::mt19937_64 random;
+    std::vector<char> inBuffer;     // Принятые данные: [head, tail) ещё не разобраны
+    size_t head;
+    size_t tail;
+    std::vector<char> outBuffer;
+    uint64_t results;
+
+    bool faultNow(Fault kind) {
+        return settings.fault == kind && std::uniform_real_distribution<double>(0, 1)(random) < settings.faultRate;
+    }
+
+    void answer(int64_t result) {
+        if (settings.dropAfter > 0 && results >= settings.dropAfter) {
+            // Все N результатов доходят до клиента до закрытия соединения
+            flush();
+            throw std::runtime_error("dropped after " + std::to_string(results) + " results");
+        }
+        delay();
+        if (faultNow(Fault::Close)) {
+            throw std::runtime_error("injected close");
+        }
+        if (faultNow(Fault::Hang)) {
+            hang();
+        }
+        if (faultNow(Fault::Corrupt)) {
+            // У double младший бит мантиссы в пределах точности сравнения клиента — меняется порядок
+            result ^= settings.type == ElementType::Double ? int64_t(1) << 52 : 1;
+        }
+        if (faultNow(Fault::Stall)) {
+            flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(settings.stallMs));
+        }
+        char encoded[sizeof(int64_t)];
+        encodeSlot(result, settings.type, encoded);
+        send(encoded, width);
+        ++results;
+    }
+
+    // Имитация вычисления; готовые результаты уходят до задержки,
+    // чтобы она не копилась в каждом результате пачки
+    void delay() {
+        if (settings.delayUs == 0 && settings.jitterUs == 0) {
+            return;
+        }
+        flush();
+        unsigned extra = settings.jitterUs ? std::uniform_int_distribution<unsigned>(0, settings.jitterUs)(random) : 0;
+        auto duration = std::chrono::microseconds(settings.delayUs + extra);
+        if (duration >= spinLimit) {
+            std::this_thread::sleep_for(duration);
+            return;
+        }
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+    // Сервер перестаёт отвечать, но читает данные, пока клиент не закроет соединение
+    [[noreturn]] void hang() {
+        flush();
+        while (true) {
+            ssize_t got = recv(fd, inBuffer.data(), inBuffer.size(), 0);
+            if (got == 0 || (got == -1 && errno != EINTR)) {
+                throw std::runtime_error("injected hang");
+            }
+        }
+    }
+
+    void send(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        outBuffer.insert(outBuffer.end(), bytes, bytes + size);
+    }
+
+    void flush() {
+        size_t sent = 0;
+        while (sent < outBuffer.size()) {
+            ssize_t written = ::send(fd, outBuffer.data() + sent, outBuffer.size() - sent, MSG_NOSIGNAL);
+            if (written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw ClientClosed();
+            }
+            sent += written;
+        }
+        outBuffer.clear();
+    }
+
+    // Не меньше need байт в [head, tail)
+    void fill(size_t need) {
+        if (tail - head >= need) {
+            return;
+        }
+        flush();
+        std::memmove(inBuffer.data(), inBuffer.data() + head, tail - head);
+        tail -= head;
+        head = 0;
+        if (inBuffer.size() < need) {
+            inBuffer.resize(need);
+        }
+        while (tail < need) {
+            ssize_t got = recv(fd, inBuffer.data() + tail, inBuffer.size() - tail, 0);
+            if (got == 0) {
+                throw ClientClosed();
+            }
+            if (got == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("receive failed: ") + std::strerror(errno));
+            }
+            tail += got;
+        }
+    }
+
+    void read(void* data, size_t size) {
+        fill(size);
+        std::memcpy(data, inBuffer.data() + head, size);
+        head += size;
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    enum { OPT_OPERATION = 256, OPT_JITTER, OPT_FAULT, OPT_FAULT_RATE, OPT_STALL, OPT_DROP_AFTER, OPT_SEED };
+    static const option longOptions[] = {
+        {"operation", required_argument, nullptr, OPT_OPERATION},
+        {"delay", required_argument, nullptr, 'd'},
+        {"jitter", required_argument, nullptr, OPT_JITTER},
+        {"fault", required_argument, nullptr, OPT_FAULT},
+        {"fault-rate", required_argument, nullptr, OPT_FAULT_RATE},
+        {"stall", required_argument, nullptr, OPT_STALL},
+        {"drop-after", required_argument, nullptr, OPT_DROP_AFTER},
+        {"seed", required_argument, nullptr, OPT_SEED},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    Settings settings;
+    try {
+        int opt;
+        while ((opt = getopt_long(argc, argv, "a:p:c:t:d:h", longOptions, nullptr)) != -1) {
+            switch (opt) {
+                case 'a':
+                    settings.address = optarg;
+                    break;
+                case 'p':
+                    settings.port = std::stoi(optarg);
+                    break;
+                case 'c':
+                    settings.configFile = optarg;
+                    break;
+                case 't':
+                    if (!parseElementType(optarg, settings.type)) {
+                        throw std::invalid_argument(std::string("unknown element type: ") + optarg);
+                    }
+                    break;
+                case OPT_OPERATION:
+                    if (!VectorCompute::parseOperation(optarg, settings.operation)) {
+                        throw std::invalid_argument(std::string("unknown operation: ") + optarg);
+                    }
+                    break;
+                case 'd':
+                    settings.delayUs = std::stoul(optarg);
+                    break;
+                case OPT_JITTER:
+                    settings.jitterUs = std::stoul(optarg);
+                    break;
+                case OPT_FAULT:
+                    if (!parseFault(optarg, settings.fault)) {
+                        throw std::invalid_argument(std::string("unknown fault: ") + optarg);
+                    }
+                    break;
+                case OPT_FAULT_RATE:
+                    settings.faultRate = std::stod(optarg);
+                    break;
+                case OPT_STALL:
+                    settings.stallMs = std::stoul(optarg);
+                    break;
+                case OPT_DROP_AFTER:
+                    settings.dropAfter = std::stoull(optarg);
+                    break;
+                case OPT_SEED:
+                    settings.seed = std::stoull(optarg);
+                    break;
+                case 'h':
+                    printHelp();
+                    return 0;
+                default:
+                    printHelp();
+                    return 1;
+            }
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: Invalid option value: " << ex.what() << std::endl;
+        return 1;
+    }
+    if (settings.fault != Fault::None && settings.faultRate <= 0) {
+        settings.faultRate = 1;
+    }
+
+    int listenFd = -1;
+    std::string login, password;
+    try {
+        readLoginPassword(settings.configFile, login, password);
+
+        sockaddr_storage address;
+        socklen_t addressLength = resolveServerAddress(settings.address, settings.port, address);
+        listenFd = socket(address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd == -1) {
+            throw std::runtime_error("Failed to create socket");
+        }
+        if (address.ss_family == AF_UNIX) {
+            unlink(reinterpret_cast<sockaddr_un*>(&address)->sun_path);
+        } else {
+            int reuse = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), addressLength) == -1 || listen(listenFd, 128) == -1) {
+            throw std::runtime_error(std::string("Failed to listen on ") + settings.address + ": " +
+                                     std::strerror(errno));
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    uint64_t seed = settings.seed ? settings.seed : std::random_device()();
+    bool tcp = settings.address.rfind("unix:", 0) != 0;
+    log("Listening on " + settings.address + (tcp ? ":" + std::to_string(settings.port) : ""));
+
+    // Каждый клиент обслуживается своим потоком
+    for (uint64_t client = 1;; ++client) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            std::cerr << "Error: Failed to accept: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        if (tcp) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        std::thread([&, fd, client]() {
+            Session session(fd, settings, login, password, seed + client);
+            std::string outcome;
+            try {
+                if (!session.authenticate()) {
+                    log("Client " + std::to_string(client) + ": authentication rejected");
+                    return;
+                }
+                session.serve();
+            } catch (const ClientClosed&) {
+                outcome = "disconnected";
+            } catch (const std::exception& ex) {
+                outcome = ex.what();
+            }
+            log("Client " + std::to_string(client) + ": " + std::to_string(session.processed()) + " vectors, " +
+                outcome);
+        }).detach();
+    }
+}
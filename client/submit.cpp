@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Отправка задания фоновому клиенту (client --daemon, протокол — в Daemon.h)
+
+void printHelp() {
+    std::cout << "Usage: vclient-submit -d <socket> -i <input_file> -o <output_file>\n";
+    std::cout << "Options:\n";
+    std::cout << "  -d socket      Unix socket of the running client --daemon (required)\n";
+    std::cout << "  -i input_file  Input file name (required)\n";
+    std::cout << "  -o output_file Output file name (required)\n";
+    std::cout << "  -h             Display help\n";
+}
+
+// Фоновый клиент работает в своём каталоге, поэтому пути передаются абсолютными
+std::string absolutePath(const std::string& path) {
+    if (!path.empty() && path[0] == '/') {
+        return path;
+    }
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+        return path;
+    }
+    return std::string(cwd) + "/" + path;
+}
+
+int main(int argc, char** argv) {
+    std::string socketPath;
+    std::string inputFile;
+    std::string outputFile;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:i:o:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                socketPath = optarg;
+                break;
+            case 'i':
+                inputFile = optarg;
+                break;
+            case 'o':
+                outputFile = optarg;
+                break;
+            case 'h':
+                printHelp();
+                return 0;
+            default:
+                printHelp();
+                return 1;
+        }
+    }
+
+    if (socketPath.empty() || inputFile.empty() || outputFile.empty()) {
+        std::cerr << "Error: Missing required parameters.\n";
+        printHelp();
+        return 1;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long: " << socketPath << std::endl;
+        return 1;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        std::cerr << "Error: Failed to connect to daemon " << socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::string request = absolutePath(inputFile) + "\n" + absolutePath(outputFile) + "\n";
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+        std::cerr << "Error: Failed to send job to daemon" << std::endl;
+        close(fd);
+        return 1;
+    }
+
+    // Ответ — одна строка после завершения задания
+    std::string response;
+    char buffer[1024];
+    ssize_t got;
+    while (response.find('\n') == std::string::npos && (got = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, got);
+    }
+    close(fd);
+
+    if (response.compare(0, 3, "OK ") == 0) {
+        std::cout << "Processed " << response.substr(3, response.find('\n') - 3) << " vectors into " << outputFile
+                  << std::endl;
+        return 0;
+    }
+    if (response.compare(0, 6, "ERROR ") == 0) {
+        std::cerr << "Error: " << response.substr(6, response.find('\n') - 6) << std::endl;
+    } else {
+        std::cerr << "Error: No response from daemon" << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,115 @@
+#include "DataWriter.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cstdio>
+#include <getopt.h>
+
+// Замер записи строк: прежняя запись через std::ofstream с std::endl на
+// каждой строке и DataWriter с разными политиками сброса. Время включает
+// закрытие файла, то есть передачу всех данных ядру (и fsync для fsync)
+
+using Clock = std::chrono::steady_clock;
+
+void printHelp() {
+    std::cout << "Usage: vclient-writerbench [-n lines] [-o file] [-b buffer_bytes]\n";
+    std::cout << "Options:\n";
+    std::cout << "  -n lines       Lines written in each case (default: 2000000)\n";
+    std::cout << "  -o file        Scratch file, removed at exit (default: writerbench.tmp)\n";
+    std::cout << "  -b bytes       DataWriter buffer size (default: 1048576)\n";
+    std::cout << "  -h             Display help\n";
+}
+
+struct Result {
+    double seconds = 0;
+    double maxCallUs = 0;   // Самый долгий вызов записи строки
+};
+
+// write(i) записывает i-ю строку, finish закрывает файл
+Result measure(size_t lines, const std::function<void(size_t)>& write, const std::function<void()>& finish) {
+    Result result;
+    auto start = Clock::now();
+    auto previous = start;
+    for (size_t i = 0; i < lines; ++i) {
+        write(i);
+        auto now = Clock::now();
+        result.maxCallUs = std::max(result.maxCallUs, std::chrono::duration<double, std::micro>(now - previous).count());
+        previous = now;
+    }
+    finish();
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+void report(const std::string& name, const Result& result, size_t lines, size_t bytes) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.seconds * 1e3 << " ms" << std::setw(10) << lines / result.seconds / 1e6
+              << " Mlines/s" << std::setw(10) << bytes / result.seconds / 1e6 << " MB/s" << std::setw(10)
+              << result.maxCallUs << " us max call" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t lines = 2000000;
+    std::string file = "writerbench.tmp";
+    size_t bufferSize = 1 << 20;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:b:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                lines = std::stoull(optarg);
+                break;
+            case 'o':
+                file = optarg;
+                break;
+            case 'b':
+                bufferSize = std::stoull(optarg);
+                break;
+            case 'h':
+                printHelp();
+                return 0;
+            default:
+                printHelp();
+                return 1;
+        }
+    }
+
+    // Строки вида, который выводит клиент; готовятся заранее, чтобы
+    // замерялась только запись
+    std::vector<std::string> samples;
+    size_t bytes = 0;
+    for (size_t i = 0; i < 1024; ++i) {
+        samples.push_back("Received result: " + std::to_string(i * 0x9E3779B97F4A7C15ULL >> 5));
+    }
+    for (size_t i = 0; i < lines; ++i) {
+        bytes += samples[i % samples.size()].size() + 1;
+    }
+
+    try {
+        {
+            std::ofstream out(file);
+            Result result = measure(
+                lines, [&](size_t i) { out << samples[i % samples.size()] << std::endl; }, [&]() { out.close(); });
+            report("ofstream + endl", result, lines, bytes);
+        }
+        for (const char* name : {"none", "lines:1000", "ms:10", "fsync"}) {
+            DataWriter::FlushPolicy policy;
+            DataWriter::FlushPolicy::parse(name, policy);
+            DataWriter writer(file, policy, bufferSize);
+            Result result = measure(
+                lines, [&](size_t i) { writer.writeLine(samples[i % samples.size()]); }, [&]() { writer.close(); });
+            report(std::string("DataWriter ") + name, result, lines, bytes);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        std::remove(file.c_str());
+        return 1;
+    }
+    std::remove(file.c_str());
+    return 0;
+}